@@ -1,3 +1,6 @@
+import hashlib
+import json
+import os
 import re
 import struct
 import sys
@@ -68,10 +71,64 @@ IMAGE_FORMAT = {
     "rg32float": (0x8230, 0x8227, 0x1406, 0x1800, 2, 8, 1, 1, "f"),
     "rgba32float": (0x8814, 0x1908, 0x1406, 0x1800, 4, 16, 1, 1, "f"),
     "rgb10a2unorm": (0x8059, 0x1908, 0x8368, 0x1800, 4, 4, 1, 1, "f"),
+    "rg11b10ufloat": (0x8C3A, 0x1907, 0x8C3B, 0x1800, 3, 4, 1, 1, "f"),
+    "rgb9e5ufloat": (0x8C3D, 0x1907, 0x8C3E, 0x1800, 3, 4, 1, 1, "e"),
+    "rgba8unorm-srgb": (0x8C43, 0x1908, 0x1401, 0x1800, 4, 4, 1, 1, "f"),
+    "rgba4unorm": (0x8056, 0x1908, 0x8033, 0x1800, 4, 2, 1, 1, "f"),
+    "rgb565unorm": (0x8D62, 0x1907, 0x8363, 0x1800, 3, 2, 1, 1, "f"),
+    "r16unorm": (0x822A, 0x1903, 0x1403, 0x1800, 1, 2, 1, 1, "f"),
+    "rg16unorm": (0x822C, 0x8227, 0x1403, 0x1800, 2, 4, 1, 1, "f"),
+    "rgba16unorm": (0x805B, 0x1908, 0x1403, 0x1800, 4, 8, 1, 1, "f"),
     "depth16unorm": (0x81A5, 0x1902, 0x1403, 0x1801, 1, 2, 0, 2, "f"),
     "depth24plus": (0x81A6, 0x1902, 0x1405, 0x1801, 1, 4, 0, 2, "f"),
     "depth24plus-stencil8": (0x88F0, 0x84F9, 0x84FA, 0x84F9, 2, 4, 0, 6, "x"),
     "depth32float": (0x8CAC, 0x1902, 0x1406, 0x1801, 1, 4, 0, 2, "f"),
+    "bc1-rgba-unorm": (0x83F1, 0, 0, 0x1800, 4, 8, 1, 1, "f", 4, 4, "s3tc"),
+    "bc2-rgba-unorm": (0x83F2, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "s3tc"),
+    "bc3-rgba-unorm": (0x83F3, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "s3tc"),
+    "bc4-r-unorm": (0x8DBB, 0, 0, 0x1800, 1, 8, 1, 1, "f", 4, 4, "rgtc"),
+    "bc4-r-snorm": (0x8DBC, 0, 0, 0x1800, 1, 8, 1, 1, "f", 4, 4, "rgtc"),
+    "bc5-rg-unorm": (0x8DBD, 0, 0, 0x1800, 2, 16, 1, 1, "f", 4, 4, "rgtc"),
+    "bc5-rg-snorm": (0x8DBE, 0, 0, 0x1800, 2, 16, 1, 1, "f", 4, 4, "rgtc"),
+    "bc6h-rgb-ufloat": (0x8E8F, 0, 0, 0x1800, 3, 16, 1, 1, "f", 4, 4, "bptc"),
+    "bc6h-rgb-float": (0x8E8E, 0, 0, 0x1800, 3, 16, 1, 1, "f", 4, 4, "bptc"),
+    "bc7-rgba-unorm": (0x8E8C, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "bptc"),
+    "bc7-rgba-unorm-srgb": (0x8E8D, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "bptc"),
+    "etc2-rgb8unorm": (0x9274, 0, 0, 0x1800, 3, 8, 1, 1, "f", 4, 4, "etc2"),
+    "etc2-rgb8unorm-srgb": (0x9275, 0, 0, 0x1800, 3, 8, 1, 1, "f", 4, 4, "etc2"),
+    "etc2-rgb8a1unorm": (0x9276, 0, 0, 0x1800, 4, 8, 1, 1, "f", 4, 4, "etc2"),
+    "etc2-rgba8unorm": (0x9278, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "etc2"),
+    "etc2-rgba8unorm-srgb": (0x9279, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "etc2"),
+    "eac-r11unorm": (0x9270, 0, 0, 0x1800, 1, 8, 1, 1, "f", 4, 4, "etc2"),
+    "eac-r11snorm": (0x9271, 0, 0, 0x1800, 1, 8, 1, 1, "f", 4, 4, "etc2"),
+    "eac-rg11unorm": (0x9272, 0, 0, 0x1800, 2, 16, 1, 1, "f", 4, 4, "etc2"),
+    "eac-rg11snorm": (0x9273, 0, 0, 0x1800, 2, 16, 1, 1, "f", 4, 4, "etc2"),
+    "astc-4x4-unorm": (0x93B0, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "astc"),
+    "astc-4x4-unorm-srgb": (0x93D0, 0, 0, 0x1800, 4, 16, 1, 1, "f", 4, 4, "astc"),
+    "astc-5x5-unorm": (0x93B2, 0, 0, 0x1800, 4, 16, 1, 1, "f", 5, 5, "astc"),
+    "astc-5x5-unorm-srgb": (0x93D2, 0, 0, 0x1800, 4, 16, 1, 1, "f", 5, 5, "astc"),
+    "astc-6x6-unorm": (0x93B4, 0, 0, 0x1800, 4, 16, 1, 1, "f", 6, 6, "astc"),
+    "astc-6x6-unorm-srgb": (0x93D4, 0, 0, 0x1800, 4, 16, 1, 1, "f", 6, 6, "astc"),
+    "astc-8x8-unorm": (0x93B7, 0, 0, 0x1800, 4, 16, 1, 1, "f", 8, 8, "astc"),
+    "astc-8x8-unorm-srgb": (0x93D7, 0, 0, 0x1800, 4, 16, 1, 1, "f", 8, 8, "astc"),
+    "astc-10x10-unorm": (0x93BB, 0, 0, 0x1800, 4, 16, 1, 1, "f", 10, 10, "astc"),
+    "astc-10x10-unorm-srgb": (0x93DB, 0, 0, 0x1800, 4, 16, 1, 1, "f", 10, 10, "astc"),
+    "astc-12x12-unorm": (0x93BD, 0, 0, 0x1800, 4, 16, 1, 1, "f", 12, 12, "astc"),
+    "astc-12x12-unorm-srgb": (0x93DD, 0, 0, 0x1800, 4, 16, 1, 1, "f", 12, 12, "astc"),
+}
+
+COMPRESSED_FORMAT_EXTENSIONS = {
+    "s3tc": ("GL_EXT_texture_compression_s3tc", "WEBGL_compressed_texture_s3tc"),
+    "rgtc": ("GL_ARB_texture_compression_rgtc", "GL_EXT_texture_compression_rgtc", "EXT_texture_compression_rgtc"),
+    "bptc": ("GL_ARB_texture_compression_bptc", "GL_EXT_texture_compression_bptc", "EXT_texture_compression_bptc"),
+    "etc2": ("GL_ARB_ES3_compatibility", "WEBGL_compressed_texture_etc"),
+    "astc": ("GL_KHR_texture_compression_astc_ldr", "WEBGL_compressed_texture_astc"),
+}
+
+EXTENSION_FORMATS = {
+    "r16unorm": ("GL_EXT_texture_norm16", "EXT_texture_norm16"),
+    "rg16unorm": ("GL_EXT_texture_norm16", "EXT_texture_norm16"),
+    "rgba16unorm": ("GL_EXT_texture_norm16", "EXT_texture_norm16"),
 }
 
 TOPOLOGY = {
@@ -127,6 +184,7 @@ BUFFER_ACCESS = {
     "dynamic_draw": 0x88E8,
     "dynamic_read": 0x88E9,
     "dynamic_copy": 0x88EA,
+    "stream_persistent": 0x88E0,
 }
 
 CULL_FACE = {
@@ -298,6 +356,23 @@ class DefaultLoader:
         self.load_opengl_function = loader
 
 
+class NullLoader:
+    def __init__(self, symbols, calls, interface=None):
+        self.symbols = symbols
+        self.counters = calls.cast("q")
+        self.interface = interface if interface is not None else ([], [], [])
+
+    def load_opengl_function(self, name):
+        return self.symbols.get(name, 0)
+
+    def calls(self):
+        return {name: count for name, count in zip(self.symbols, self.counters) if count}
+
+    def reset(self):
+        for i in range(len(self.counters)):
+            self.counters[i] = 0
+
+
 def loader(headless=False):
     if headless:
         import glcontext
@@ -392,12 +467,28 @@ def bind(buffer, layout, *attributes):
     return res
 
 
-def vertex_array_bindings(vertex_buffers, index_buffer):
+def compressed_formats(extensions, gles):
+    extensions = set(extensions)
+    families = {key for key, names in COMPRESSED_FORMAT_EXTENSIONS.items() if extensions.intersection(names)}
+    if gles:
+        families.add("etc2")
+    return tuple(name for name, fmt in IMAGE_FORMAT.items() if len(fmt) > 9 and fmt[11] in families)
+
+
+def extension_formats(extensions, gles):
+    extensions = set(extensions)
+    return tuple(name for name, names in EXTENSION_FORMATS.items() if not gles or extensions.intersection(names))
+
+
+def vertex_array_bindings(vertex_buffers, index_buffer, buffer_view_type):
     res = [index_buffer]
     for obj in vertex_buffers:
         buffer = obj["buffer"]
+        offset = obj["offset"]
+        if isinstance(buffer, buffer_view_type):
+            buffer, offset = buffer.buffer, buffer.offset + offset
         if buffer is not None:
-            res.extend([buffer, obj["location"], obj["offset"], obj["stride"], STEP[obj["step"]], obj["format"]])
+            res.extend([buffer, obj["location"], offset, obj["stride"], STEP[obj["step"]], obj["format"]])
     return tuple(res)
 
 
@@ -407,8 +498,11 @@ def resource_bindings(resources):
         binding = obj["binding"]
         buffer = obj["buffer"]
         offset = obj.get("offset", 0)
+        dynamic = obj.get("dynamic", False)
+        if dynamic and "size" not in obj:
+            raise ValueError("dynamic uniform buffers require a size")
         size = obj.get("size", buffer.size - offset)
-        uniform_buffers.extend([binding, buffer, offset, size])
+        uniform_buffers.extend([binding, buffer, offset, size, int(dynamic)])
 
     samplers = []
     for obj in sorted((x for x in resources if x["type"] == "sampler"), key=lambda x: x["binding"]):
@@ -543,6 +637,46 @@ def program(vertex_shader, fragment_shader, layout, includes):
     return (vert, 0x8B31), (frag, 0x8B30), tuple(bindings)
 
 
+def program_binary_filename(path, program, info):
+    key = repr((program, info["vendor"], info["renderer"], info["version"]))
+    return os.path.join(path, hashlib.sha1(key.encode()).hexdigest() + ".bin")
+
+
+def load_program_binary(path, program, info):
+    filename = program_binary_filename(path, program, info)
+    try:
+        with open(filename, "rb") as f:
+            data = f.read()
+        binary_format, header_size = struct.unpack("ii", data[:8])
+        interface = json.loads(data[8 : 8 + header_size])
+        binary = data[8 + header_size :]
+    except (OSError, ValueError, struct.error):
+        return None
+    if not binary:
+        return None
+    return binary_format, binary, tuple(interface)
+
+
+def save_program_binary(path, program, info, binary_format, binary, interface):
+    filename = program_binary_filename(path, program, info)
+    header = json.dumps(interface).encode()
+    temp = f"{filename}.{os.getpid()}.tmp"
+    try:
+        os.makedirs(path, exist_ok=True)
+        with open(temp, "wb") as f:
+            f.write(struct.pack("ii", binary_format, len(header)) + header + binary)
+        os.replace(temp, filename)
+    except OSError:
+        pass
+
+
+def remove_program_binary(path, program, info):
+    try:
+        os.remove(program_binary_filename(path, program, info))
+    except OSError:
+        pass
+
+
 def compile_error(shader: bytes, shader_type: int, log: bytes):
     name = {0x8B31: "Vertex Shader", 0x8B30: "Fragment Shader"}[shader_type]
     log = log.rstrip(b"\x00").decode()
@@ -574,7 +708,14 @@ def uniforms(interface, selection, uniform_data):
     layout = bytearray()
     offset = 0
 
-    layout.extend(struct.pack("i", len(selection)))
+    shadow_map = {}
+    shadow_size = 0
+    for obj in interface[1]:
+        if obj["gltype"] in UNIFORM_PACKER:
+            shadow_map[clean_glsl_name(obj["name"])] = shadow_size
+            shadow_size += 4 + obj["size"] * UNIFORM_PACKER[obj["gltype"]][1] * 4
+
+    layout.extend(struct.pack("2i", len(selection), shadow_size))
     for name, values in selection.items():
         if name not in uniform_map:
             raise KeyError(f'Uniform "{name}" does not exist')
@@ -596,7 +737,7 @@ def uniforms(interface, selection, uniform_data):
             raise ValueError(f'Uniform "{name}" must be {size * items} long at most')
         if values_count % items:
             raise ValueError(f'Uniform "{name}" must have a length divisible by {items}')
-        layout.extend(struct.pack("4i", function, location, count, offset))
+        layout.extend(struct.pack("6i", function, location, count, offset, shadow_map[name], len(values)))
         uniforms.append((name, slice(offset, offset + len(values)), values))
         offset += len(values)
 
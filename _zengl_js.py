@@ -23,7 +23,12 @@ zengl_js = """
       case 0x1404: return wasm.HEAP32.subarray(ptr >> 2, (ptr >> 2) + (size << 2));
       case 0x1405: return wasm.HEAPU32.subarray(ptr >> 2, (ptr >> 2) + (size << 2));
       case 0x1406: return wasm.HEAPF32.subarray(ptr >> 2, (ptr >> 2) + (size << 2));
+      case 0x8033: return wasm.HEAPU16.subarray(ptr >> 1, (ptr >> 1) + (size << 1));
+      case 0x8363: return wasm.HEAPU16.subarray(ptr >> 1, (ptr >> 1) + (size << 1));
+      case 0x8368: return wasm.HEAPU32.subarray(ptr >> 2, (ptr >> 2) + (size << 2));
       case 0x84FA: return wasm.HEAPU32.subarray(ptr >> 2, (ptr >> 2) + (size << 2));
+      case 0x8C3B: return wasm.HEAPU32.subarray(ptr >> 2, (ptr >> 2) + (size << 2));
+      case 0x8C3E: return wasm.HEAPU32.subarray(ptr >> 2, (ptr >> 2) + (size << 2));
     };
   };
 
@@ -31,6 +36,7 @@ zengl_js = """
     switch (format) {
       case 0x1903: return 1;
       case 0x8227: return 2;
+      case 0x1907: return 3;
       case 0x1908: return 4;
       case 0x8D94: return 1;
       case 0x8228: return 2;
@@ -39,6 +45,25 @@ zengl_js = """
     }
   };
 
+  const elementCount = (format, type) => {
+    switch (type) {
+      case 0x8033: return 1;
+      case 0x8363: return 1;
+      case 0x8368: return 1;
+      case 0x8C3B: return 1;
+      case 0x8C3E: return 1;
+    }
+    return componentCount(format);
+  };
+
+  const pixelStore = new Map([[0x0CF2, 0], [0x806E, 0], [0x0D02, 0]]);
+
+  const pixelCount = (width, height, depth, format, type, rowLength, imageHeight) => {
+    const row = pixelStore.get(rowLength) || width;
+    const image = (imageHeight && pixelStore.get(imageHeight)) || height;
+    return (row * (image * (depth - 1) + height - 1) + width) * elementCount(format, type);
+  };
+
   const glo = new Map();
   let glid = 1;
   glo[0] = null;
@@ -79,13 +104,21 @@ zengl_js = """
       gl.readBuffer(src);
     },
     zengl_glReadPixels(x, y, width, height, format, type, pixels) {
-      const data = typedArray(type, pixels, width * height * componentCount(format));
+      if (gl.getParameter(gl.PIXEL_PACK_BUFFER_BINDING)) {
+        gl.readPixels(x, y, width, height, format, type, pixels);
+        return;
+      }
+      const data = typedArray(type, pixels, pixelCount(width, height, 1, format, type, 0x0D02));
       gl.readPixels(x, y, width, height, format, type, data);
     },
     zengl_glGetError() {
       return gl.getError();
     },
     zengl_glGetIntegerv(pname, data) {
+      if (pname === 0x821D) {
+        wasm.HEAP32[data >> 2] = gl.getSupportedExtensions().length;
+        return;
+      }
       const value = gl.getParameter(pname);
       wasm.HEAP32[data >> 2] = Math.min(value, 0x7ffffff);
     },
@@ -96,7 +129,7 @@ zengl_js = """
       gl.viewport(x, y, width, height);
     },
     zengl_glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels) {
-      const data = typedArray(type, pixels, width * height * componentCount(format));
+      const data = typedArray(type, pixels, pixelCount(width, height, 1, format, type, 0x0CF2));
       gl.texSubImage2D(target, level, xoffset, yoffset, width, height, format, type, data);
     },
     zengl_glBindTexture(target, texture) {
@@ -116,7 +149,7 @@ zengl_js = """
       gl.texImage3D(target, level, internalformat, width, height, depth, border, format, type, null);
     },
     zengl_glTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, pixels) {
-      const data = typedArray(type, pixels, width * height * depth * componentCount(format));
+      const data = typedArray(type, pixels, pixelCount(width, height, depth, format, type, 0x0CF2, 0x806E));
       gl.texSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, type, data);
     },
     zengl_glActiveTexture(texture) {
@@ -131,6 +164,13 @@ zengl_js = """
       glo[query] = gl.createQuery();
       wasm.HEAP32[ids >> 2] = query;
     },
+    zengl_glDeleteQueries(n, ids) {
+      for (let i = 0; i < n; ++i) {
+        const query = wasm.HEAP32[(ids >> 2) + i];
+        gl.deleteQuery(glo[query]);
+        glo.delete(query);
+      }
+    },
     zengl_glBeginQuery(target, id) {
       gl.beginQuery(target, glo[id]);
     },
@@ -432,7 +472,7 @@ zengl_js = """
       glo.delete(sync);
     },
     zengl_glClientWaitSync(sync, flags, timeout) {
-      gl.clientWaitSync(glo[sync], flags, gl.MAX_CLIENT_WAIT_TIMEOUT_WEBGL);
+      return gl.clientWaitSync(glo[sync], flags, timeout ? gl.MAX_CLIENT_WAIT_TIMEOUT_WEBGL : 0);
     },
     zengl_glGenSamplers(count, samplers) {
       const sampler = glid++;
@@ -456,6 +496,80 @@ zengl_js = """
     zengl_glVertexAttribDivisor(index, divisor) {
       gl.vertexAttribDivisor(index, divisor);
     },
+    zengl_glGetProgramBinary(program, bufSize, length, binaryFormat, binary) {
+      wasm.HEAP32[length >> 2] = 0;
+    },
+    zengl_glProgramBinary(program, binaryFormat, binary, length) {
+    },
+    zengl_glProgramParameteri(program, pname, value) {
+    },
+    zengl_glMultiDrawArrays(mode, first, count, drawcount) {
+      const ext = gl.getExtension('WEBGL_multi_draw');
+      if (ext) {
+        ext.multiDrawArraysWEBGL(mode, wasm.HEAP32, first >> 2, wasm.HEAP32, count >> 2, drawcount);
+        return;
+      }
+      for (let i = 0; i < drawcount; ++i) {
+        gl.drawArrays(mode, wasm.HEAP32[(first >> 2) + i], wasm.HEAP32[(count >> 2) + i]);
+      }
+    },
+    zengl_glMultiDrawElements(mode, count, type, indices, drawcount) {
+      const ext = gl.getExtension('WEBGL_multi_draw');
+      if (ext) {
+        ext.multiDrawElementsWEBGL(mode, wasm.HEAP32, count >> 2, type, wasm.HEAP32, indices >> 2, drawcount);
+        return;
+      }
+      for (let i = 0; i < drawcount; ++i) {
+        gl.drawElements(mode, wasm.HEAP32[(count >> 2) + i], type, wasm.HEAP32[(indices >> 2) + i]);
+      }
+    },
+    zengl_glDrawElementsInstancedBaseVertex(mode, count, type, indices, instancecount, basevertex) {
+    },
+    zengl_glDrawArraysInstancedBaseInstance(mode, first, count, instancecount, baseinstance) {
+    },
+    zengl_glDrawElementsInstancedBaseVertexBaseInstance(mode, count, type, indices, instancecount, basevertex, baseinstance) {
+    },
+    zengl_glDrawArraysIndirect(mode, indirect) {
+    },
+    zengl_glDrawElementsIndirect(mode, type, indirect) {
+    },
+    zengl_glMultiDrawArraysIndirect(mode, indirect, drawcount, stride) {
+    },
+    zengl_glMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride) {
+    },
+    zengl_glQueryCounter(id, target) {
+    },
+    zengl_glGetQueryObjectui64v(id, pname, params) {
+    },
+    zengl_glBufferStorage(target, size, data, flags) {
+    },
+    zengl_glMapBufferRange(target, offset, length, access) {
+      return 0;
+    },
+    zengl_glUnmapBuffer(target) {
+      return 0;
+    },
+    zengl_glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data) {
+      gl.compressedTexImage2D(target, level, internalformat, width, height, border, new Uint8Array(imageSize));
+    },
+    zengl_glCompressedTexImage3D(target, level, internalformat, width, height, depth, border, imageSize, data) {
+      gl.compressedTexImage3D(target, level, internalformat, width, height, depth, border, new Uint8Array(imageSize));
+    },
+    zengl_glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data) {
+      gl.compressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, wasm.HEAPU8.subarray(data, data + imageSize));
+    },
+    zengl_glCompressedTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, imageSize, data) {
+      gl.compressedTexSubImage3D(target, level, xoffset, yoffset, zoffset, width, height, depth, format, wasm.HEAPU8.subarray(data, data + imageSize));
+    },
+    zengl_glGetStringi(name, index) {
+      const extension = gl.getSupportedExtensions()[index];
+      gl.getExtension(extension);
+      return wasm.allocateUTF8(extension);
+    },
+    zengl_glPixelStorei(pname, param) {
+      pixelStore.set(pname, param);
+      gl.pixelStorei(pname, param);
+    },
   };
 }
 """
@@ -1,5 +1,6 @@
 import math
 import struct
+from collections import deque
 
 import ffmpeg
 import numpy as np
@@ -120,6 +121,14 @@ process2 = (
 )
 
 frame = 0
+frames_in_flight = 3
+readbacks = deque()
+
+
+def write_frame(readback):
+    out_frame = np.frombuffer(readback.result(), 'u1').reshape(width, height, 4)[:, :, :3]
+    process2.stdin.write(out_frame.tobytes())
+
 
 while True:
     data = np.full((height, width, 4), 255, 'u1')
@@ -142,9 +151,12 @@ while True:
     cube.render()
     image.blit(output)
 
-    out_frame = np.frombuffer(output.read(), 'u1').reshape(width, height, 4)[:, :, :3]
+    readbacks.append(output.read_async())
+    if len(readbacks) == frames_in_flight:
+        write_frame(readbacks.popleft())
 
-    process2.stdin.write(out_frame.tobytes())
+while readbacks:
+    write_frame(readbacks.popleft())
 
 process2.stdin.close()
 process1.wait()
@@ -0,0 +1,676 @@
+import struct
+
+import numpy as np
+import pytest
+import zengl
+
+try:
+    import pytest_benchmark
+except ImportError:
+
+    @pytest.fixture
+    def benchmark():
+        pytest.skip("pytest-benchmark is not installed")
+
+
+pytestmark = pytest.mark.skipif(not hasattr(zengl, "null_loader"), reason="built with EXTERN_GL")
+
+
+INTERFACE = (
+    [],
+    [
+        {"name": "color", "location": 0, "gltype": 0x8B51, "size": 1},
+    ],
+    [],
+)
+
+
+class state:
+    loader = None
+
+
+@pytest.fixture
+def loader():
+    if state.loader is None:
+        state.loader = zengl.null_loader(INTERFACE)
+        zengl.init(state.loader)
+    state.loader.reset()
+    return state.loader
+
+
+@pytest.fixture
+def ctx(loader):
+    ctx = zengl.context()
+    ctx.new_frame(reset=True, clear=False)
+    yield ctx
+    ctx.end_frame()
+    ctx.release("all")
+    ctx.release("shader_cache")
+    assert len(ctx.gc()) == 0
+
+
+def make_pipeline(ctx, image, viewport=None, color=(1.0, 1.0, 1.0)):
+    return ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            uniform vec3 color;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(color, 1.0);
+            }
+        """,
+        uniforms={
+            "color": color,
+        },
+        framebuffer=[image],
+        viewport=viewport,
+        topology="triangles",
+        vertex_count=3,
+    )
+
+
+def test_null_loader(ctx: zengl.Context, loader):
+    assert ctx.info["renderer"] == "null"
+
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image)
+    assert zengl.inspect(pipeline)["interface"][1][0]["name"] == "color"
+
+    loader.reset()
+    pipeline.render()
+    pipeline.render()
+    calls = loader.calls()
+    assert calls["glDrawArraysInstanced"] == 2
+    assert calls["glUniform3fv"] == 1
+
+
+def test_pipeline_render(ctx: zengl.Context, benchmark):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image)
+    benchmark(pipeline.render)
+
+
+def test_pipeline_render_loop(ctx: zengl.Context, benchmark):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipelines = [make_pipeline(ctx, image, (i, 0, 1, 1)) for i in range(64)]
+
+    def render():
+        for pipeline in pipelines:
+            pipeline.render()
+
+    benchmark(render)
+
+
+def test_context_render_batch(ctx: zengl.Context, benchmark):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipelines = [make_pipeline(ctx, image, (i, 0, 1, 1)) for i in range(64)]
+    benchmark(ctx.render, pipelines)
+
+
+def test_pipeline_create(ctx: zengl.Context, benchmark):
+    image = ctx.image((64, 64), "rgba8unorm")
+
+    def create():
+        ctx.release(make_pipeline(ctx, image))
+
+    benchmark(create)
+
+
+def test_buffer_write(ctx: zengl.Context, benchmark):
+    buffer = ctx.buffer(size=1024)
+    data = bytes(1024)
+    benchmark(buffer.write, data)
+
+
+@pytest.mark.parametrize("count", [1000, 10000, 100000])
+def test_pipeline_create_release(ctx: zengl.Context, loader, benchmark, count):
+    loader.interface = (
+        [
+            {"name": "in_vert", "location": 0, "gltype": 0x8B50, "size": 1},
+        ],
+        [],
+        [],
+    )
+
+    def create_release():
+        image = ctx.image((64, 64), "rgba8unorm")
+        for _ in range(count):
+            ctx.pipeline(
+                vertex_shader="""
+                    #version 330 core
+
+                    layout (location = 0) in vec2 in_vert;
+
+                    void main() {
+                        gl_Position = vec4(in_vert, 0.0, 1.0);
+                    }
+                """,
+                fragment_shader="""
+                    #version 330 core
+
+                    layout (location = 0) out vec4 out_color;
+
+                    void main() {
+                        out_color = vec4(1.0);
+                    }
+                """,
+                framebuffer=[image],
+                topology="triangles",
+                vertex_buffers=zengl.bind(ctx.buffer(size=24), "2f", 0),
+                vertex_count=3,
+            )
+        ctx.release("all")
+
+    try:
+        benchmark.pedantic(create_release, rounds=1)
+    finally:
+        loader.interface = INTERFACE
+
+
+def make_material_pipelines(ctx, loader, count):
+    loader.interface = (
+        [],
+        [
+            {"name": "Shared", "location": 0, "gltype": 0x8B5E, "size": 1},
+            {"name": "Material", "location": 1, "gltype": 0x8B5E, "size": 1},
+        ],
+        [
+            {"name": "Camera", "size": 64},
+        ],
+    )
+    image = ctx.image((64, 64), "rgba8unorm")
+    camera = ctx.buffer(size=64)
+    shared = ctx.image((4, 4), "rgba8unorm")
+    pipelines = []
+    for _ in range(count):
+        material = ctx.image((4, 4), "rgba8unorm")
+        pipeline = ctx.pipeline(
+            vertex_shader="""
+                #version 330 core
+
+                layout (std140) uniform Camera {
+                    mat4 mvp;
+                };
+
+                void main() {
+                    gl_Position = mvp * vec4(0.0, 0.0, 0.0, 1.0);
+                }
+            """,
+            fragment_shader="""
+                #version 330 core
+
+                uniform sampler2D Shared;
+                uniform sampler2D Material;
+
+                layout (location = 0) out vec4 out_color;
+
+                void main() {
+                    out_color = texture(Shared, vec2(0.5, 0.5)) + texture(Material, vec2(0.5, 0.5));
+                }
+            """,
+            layout=[
+                {"name": "Camera", "binding": 0},
+                {"name": "Shared", "binding": 0},
+                {"name": "Material", "binding": 1},
+            ],
+            resources=[
+                {"type": "uniform_buffer", "binding": 0, "buffer": camera},
+                {"type": "sampler", "binding": 0, "image": shared},
+                {"type": "sampler", "binding": 1, "image": material},
+            ],
+            framebuffer=[image],
+            topology="triangles",
+            vertex_count=3,
+        )
+        pipelines.append(pipeline)
+    loader.interface = INTERFACE
+    return pipelines
+
+
+def test_descriptor_set_switch(ctx: zengl.Context, loader):
+    first, second = make_material_pipelines(ctx, loader, 2)
+    first.render()
+
+    loader.reset()
+    second.render()
+    calls = loader.calls()
+    assert calls["glBindTexture"] == 1
+    assert "glBindSampler" not in calls
+    assert "glBindBufferRange" not in calls
+
+
+def test_descriptor_set_switch_render(ctx: zengl.Context, loader, benchmark):
+    pipelines = make_material_pipelines(ctx, loader, 64)
+    benchmark(ctx.render, pipelines)
+
+
+def make_blend_pipelines(ctx, count):
+    image = ctx.image((64, 64), "rgba8unorm")
+    depth = ctx.image((64, 64), "depth24plus")
+    blending = {
+        "enable": True,
+        "src_color": "src_alpha",
+        "dst_color": "one_minus_src_alpha",
+    }
+    pipelines = []
+    for i in range(count):
+        pipeline = ctx.pipeline(
+            vertex_shader="""
+                #version 330 core
+
+                vec2 positions[3] = vec2[](
+                    vec2(-1.0, -1.0),
+                    vec2(3.0, -1.0),
+                    vec2(-1.0, 3.0)
+                );
+
+                void main() {
+                    gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+                }
+            """,
+            fragment_shader="""
+                #version 330 core
+
+                uniform vec3 color;
+
+                layout (location = 0) out vec4 out_color;
+
+                void main() {
+                    out_color = vec4(color, 0.5);
+                }
+            """,
+            uniforms={
+                "color": (1.0, 1.0, 1.0),
+            },
+            framebuffer=[image, depth],
+            depth={"func": "less", "write": i % 2 == 0},
+            cull_face="back",
+            blend=blending if i % 2 else None,
+            topology="triangles",
+            vertex_count=3,
+        )
+        pipelines.append(pipeline)
+    return pipelines
+
+
+def test_global_settings_switch(ctx: zengl.Context, loader):
+    opaque, transparent = make_blend_pipelines(ctx, 2)
+    opaque.render()
+
+    loader.reset()
+    transparent.render()
+    opaque.render()
+    calls = loader.calls()
+    assert calls["glEnable"] == 1
+    assert calls["glDisable"] == 1
+    assert calls["glDepthMask"] == 2
+    assert calls["glBlendEquationSeparate"] == 1
+    assert calls["glBlendFuncSeparate"] == 1
+    assert "glCullFace" not in calls
+    assert "glDepthFunc" not in calls
+
+
+def test_global_settings_alternate(ctx: zengl.Context, loader, benchmark):
+    pipelines = make_blend_pipelines(ctx, 64)
+    benchmark(ctx.render, pipelines)
+
+
+def make_interleaved_pipelines(ctx, count):
+    images = [ctx.image((64, 64), "rgba8unorm") for _ in range(2)]
+    pipelines = []
+    for i in range(count):
+        pipeline = ctx.pipeline(
+            vertex_shader="""
+                #version 330 core
+
+                vec2 positions[3] = vec2[](
+                    vec2(-1.0, -1.0),
+                    vec2(3.0, -1.0),
+                    vec2(-1.0, 3.0)
+                );
+
+                void main() {
+                    gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+                }
+            """,
+            fragment_shader="""
+                #version 330 core
+
+                uniform vec3 color;
+
+                layout (location = 0) out vec4 out_color;
+
+                void main() {
+                    out_color = vec4(color, %d.0);
+                }
+            """
+            % (i % 4 // 2),
+            uniforms={
+                "color": (1.0, 1.0, 1.0),
+            },
+            framebuffer=[images[i % 2]],
+            topology="triangles",
+            vertex_count=3,
+        )
+        pipelines.append(pipeline)
+    return pipelines
+
+
+def test_draw_queue_sort(ctx: zengl.Context, loader):
+    pipelines = make_interleaved_pipelines(ctx, 64)
+    queue = ctx.draw_queue()
+
+    loader.reset()
+    for pipeline in pipelines:
+        queue.add(pipeline)
+    queue.flush()
+    calls = loader.calls()
+    assert calls["glBindFramebuffer"] == 2
+    assert calls["glUseProgram"] == 4
+    assert queue.saved_binds == 63 + 31 - 4
+
+
+def test_draw_queue_flush(ctx: zengl.Context, benchmark):
+    pipelines = make_interleaved_pipelines(ctx, 64)
+    queue = ctx.draw_queue()
+
+    def flush():
+        for pipeline in pipelines:
+            queue.add(pipeline)
+        queue.flush()
+
+    benchmark(flush)
+
+
+def test_draw_queue_render_unsorted(ctx: zengl.Context, benchmark):
+    pipelines = make_interleaved_pipelines(ctx, 64)
+    benchmark(ctx.render, pipelines)
+
+
+
+def make_submeshes(count):
+    return struct.pack("%di" % (count * 5), *[x for i in range(count) for x in (3, 1, i * 3, 0, 0)])
+
+
+def test_render_multi(ctx: zengl.Context, loader):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image)
+
+    loader.reset()
+    pipeline.render_multi(make_submeshes(500))
+    calls = loader.calls()
+    assert calls["glMultiDrawArrays"] == 1
+    assert "glDrawArraysInstanced" not in calls
+
+
+def test_render_multi_submeshes(ctx: zengl.Context, benchmark):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image)
+    benchmark(pipeline.render_multi, make_submeshes(500))
+
+
+def test_render_submeshes_loop(ctx: zengl.Context, benchmark):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image)
+
+    def render():
+        for i in range(500):
+            pipeline.first_vertex = i * 3
+            pipeline.render()
+
+    benchmark(render)
+
+
+def test_render_indirect(ctx: zengl.Context, loader):
+    image = ctx.image((64, 64), "rgba8unorm")
+    indirect_buffer = ctx.buffer(size=16 * 500, indirect=True)
+    pipeline = ctx.pipeline(
+        template=make_pipeline(ctx, image),
+        indirect_buffer=indirect_buffer,
+        indirect_count=500,
+    )
+
+    loader.reset()
+    pipeline.render()
+    calls = loader.calls()
+    assert calls["glMultiDrawArraysIndirect"] == 1
+    assert "glDrawArraysInstanced" not in calls
+
+
+def test_base_vertex_shared_vertex_array(ctx: zengl.Context, loader):
+    loader.interface = (
+        [
+            {"name": "in_vert", "location": 0, "gltype": 0x8B50, "size": 1},
+        ],
+        [],
+        [],
+    )
+    image = ctx.image((64, 64), "rgba8unorm")
+    vertex_buffer = ctx.buffer(size=64 * 3 * 8)
+    index_buffer = ctx.buffer(size=3 * 4, index=True)
+    pipelines = [
+        ctx.pipeline(
+            vertex_shader="""
+                #version 330 core
+
+                layout (location = 0) in vec2 in_vert;
+
+                void main() {
+                    gl_Position = vec4(in_vert, 0.0, 1.0);
+                }
+            """,
+            fragment_shader="""
+                #version 330 core
+
+                layout (location = 0) out vec4 out_color;
+
+                void main() {
+                    out_color = vec4(1.0);
+                }
+            """,
+            framebuffer=[image],
+            topology="triangles",
+            vertex_buffers=zengl.bind(vertex_buffer, "2f", 0),
+            index_buffer=index_buffer,
+            vertex_count=3,
+            base_vertex=i * 3,
+        )
+        for i in range(64)
+    ]
+    loader.interface = INTERFACE
+
+    loader.reset()
+    ctx.render(pipelines)
+    calls = loader.calls()
+    assert calls.get("glBindVertexArray", 0) <= 1
+    assert calls["glDrawElementsInstancedBaseVertex"] == 63
+    assert calls["glDrawElementsInstanced"] == 1
+
+
+def test_read_async_reuses_buffers(ctx: zengl.Context, loader):
+    image = ctx.image((64, 64), "rgba8unorm")
+    image.read_async().result()
+
+    loader.reset()
+    readbacks = [image.read_async() for _ in range(3)]
+    for readback in readbacks:
+        readback.result()
+    readbacks = [image.read_async() for _ in range(3)]
+    for readback in readbacks:
+        readback.result()
+    calls = loader.calls()
+    assert calls["glGenBuffers"] == 2
+    assert calls["glReadPixels"] == 6
+    assert calls["glFenceSync"] == 6
+
+
+def test_frame_time_does_not_wait(ctx: zengl.Context, loader):
+    ctx.end_frame()
+    loader.reset()
+    for _ in range(8):
+        ctx.new_frame(frame_time=True)
+        ctx.end_frame()
+    calls = loader.calls()
+    assert calls["glGenQueries"] == 4
+    assert calls["glGetQueryObjectuiv"] == 16
+    assert ctx.frame_time_latency == 0
+    ctx.new_frame()
+
+
+def test_profile_reuses_queries(ctx: zengl.Context, loader):
+    image = ctx.image((4, 4), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image)
+    ctx.end_frame()
+    loader.reset()
+    for _ in range(4):
+        ctx.new_frame(profile=True)
+        pipeline.render()
+        pipeline.render()
+        ctx.end_frame()
+    ctx.new_frame()
+    pipeline.render()
+    ctx.end_frame()
+    calls = loader.calls()
+    assert calls["glGenQueries"] == 4
+    assert calls["glQueryCounter"] == 16
+    assert len(ctx.profile()) == 8
+    ctx.new_frame()
+
+
+def test_release_all_deletes_queries(ctx: zengl.Context, loader):
+    image = ctx.image((4, 4), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image)
+    ctx.end_frame()
+    for _ in range(2):
+        ctx.new_frame(frame_time=True, profile=True)
+        pipeline.render()
+        ctx.end_frame()
+    ctx.new_frame()
+    ctx.end_frame()
+    loader.reset()
+    ctx.release("all")
+    calls = loader.calls()
+    assert calls["glDeleteQueries"] == 3
+    loader.reset()
+    ctx.new_frame(frame_time=True)
+    ctx.end_frame()
+    assert loader.calls()["glGenQueries"] == 1
+    ctx.new_frame()
+
+
+def test_buffer_stream_orphans_once_per_frame(ctx: zengl.Context, loader):
+    buffer = ctx.buffer(size=1024, access="stream_persistent")
+    assert not buffer.persistent
+    ctx.end_frame()
+    loader.reset()
+    for _ in range(3):
+        ctx.new_frame()
+        for _ in range(4):
+            buffer.stream(b"x" * 100, align=16)
+        ctx.end_frame()
+    calls = loader.calls()
+    assert calls["glBufferData"] == 2
+    assert calls["glBufferSubData"] == 12
+    ctx.new_frame()
+
+
+def test_render_dynamic_uniform_buffer(ctx: zengl.Context, loader):
+    image = ctx.image((4, 4), "rgba8unorm")
+    arena = ctx.buffer(size=0x10000, uniform=True)
+    loader.interface[2].append({"name": "Object", "size": 64})
+    try:
+        pipeline = ctx.pipeline(
+            vertex_shader="#version 330 core\nuniform Object { vec4 color; };\nvoid main() {}",
+            fragment_shader="#version 330 core\nvoid main() {}",
+            layout=[{"name": "Object", "binding": 0}],
+            resources=[{"type": "uniform_buffer", "binding": 0, "buffer": arena, "size": 64, "dynamic": True}],
+            framebuffer=[image],
+            vertex_count=3,
+        )
+    finally:
+        loader.interface[2].pop()
+    pipeline.render()
+    loader.reset()
+    for i in range(100):
+        pipeline.dynamic_offset = i % 4 * 256
+        pipeline.render()
+    calls = loader.calls()
+    assert calls["glBindBufferRange"] == 99
+    assert "glUniform4fv" not in calls
+
+    pipeline.dynamic_offset = 0
+    loader.reset()
+    for _ in range(100):
+        pipeline.render()
+    assert loader.calls()["glBindBufferRange"] == 1
+
+
+def test_buffer_arena_defragment_single_pass(ctx: zengl.Context, loader):
+    arena = ctx.buffer_arena(0x10000)
+    views = [arena.allocate(size=64) for _ in range(100)]
+    for view in views[1::2]:
+        arena.free(view)
+    loader.reset()
+    assert arena.defragment() == views[2::2]
+    calls = loader.calls()
+    assert calls["glGenBuffers"] == 1
+    assert calls["glCopyBufferSubData"] == 50
+    assert calls["glDeleteBuffers"] == 1
+    assert [view.offset for view in views[::2]] == list(range(0, 3200, 64))
+
+
+def test_read_multisample_reuses_resolve_target(ctx: zengl.Context, loader):
+    image = ctx.image((64, 64), "rgba8unorm", samples=4)
+    image.read()
+    loader.reset()
+    for _ in range(10):
+        image.read()
+        image.read((16, 16), (8, 8))
+    calls = loader.calls()
+    assert "glGenTextures" not in calls
+    assert "glGenFramebuffers" not in calls
+    assert "glDeleteTextures" not in calls
+    assert calls["glBlitFramebuffer"] == 20
+    assert calls["glReadPixels"] == 20
+    ctx.release(image)
+
+
+def test_image_write_all_levels_single_bind(ctx: zengl.Context, loader):
+    image = ctx.image((1024, 1024), "rgba8unorm", levels=11)
+    buffer = ctx.buffer(size=sum(max(1024 >> i, 1) ** 2 * 4 for i in range(11)))
+    loader.reset()
+    image.write(buffer, levels="all")
+    calls = loader.calls()
+    assert calls["glTexSubImage2D"] == 11
+    assert calls["glBindBuffer"] == 2
+    ctx.release(image)
+
+
+def test_image_write_strided_tile_sets_row_length(ctx: zengl.Context, loader):
+    pixels = np.zeros((1024, 1024, 4), "u1")
+    image = ctx.image((256, 256), "rgba8unorm")
+    loader.reset()
+    image.write(pixels[256:512, 256:512])
+    calls = loader.calls()
+    assert calls["glTexSubImage2D"] == 1
+    assert calls["glPixelStorei"] == 6
+    loader.reset()
+    image.write(pixels[:256, :256].copy())
+    assert "glPixelStorei" not in loader.calls()
+    ctx.release(image)
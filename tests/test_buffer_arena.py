@@ -0,0 +1,146 @@
+import numpy as np
+import pytest
+import zengl
+
+
+def test_buffer_arena_allocate(ctx: zengl.Context):
+    arena = ctx.buffer_arena(1024)
+    first = arena.allocate(b"a" * 100)
+    second = arena.allocate(size=100, align=64)
+    assert first.buffer is arena.buffer
+    assert (first.offset, first.size) == (0, 100)
+    assert (second.offset, second.size) == (128, 100)
+    assert arena.buffer.read(100, first.offset) == b"a" * 100
+    assert len(arena) == 2
+
+    arena.free(first)
+    third = arena.allocate(b"b" * 64)
+    assert third.offset == 0
+    assert arena.stats() == {
+        "size": 1024,
+        "used": 164,
+        "free": 860,
+        "largest_free": 796,
+        "allocations": 2,
+        "fragments": 2,
+    }
+
+
+def test_buffer_arena_errors(ctx: zengl.Context):
+    arena = ctx.buffer_arena(256)
+    view = arena.allocate(size=200)
+    with pytest.raises(ValueError):
+        arena.allocate(size=100)
+    with pytest.raises(ValueError):
+        arena.allocate(size=0)
+    with pytest.raises(ValueError):
+        arena.free(arena.buffer.view())
+    arena.free(view)
+    with pytest.raises(ValueError):
+        arena.free(view)
+
+
+def test_buffer_arena_defragment(ctx: zengl.Context):
+    arena = ctx.buffer_arena(1024)
+    views = [arena.allocate(bytes([i]) * 96, align=16) for i in range(5)]
+    arena.free(views[1])
+    arena.free(views[3])
+    assert arena.stats()["fragments"] == 3
+    assert arena.defragment() == [views[2], views[4]]
+    assert [views[i].offset for i in (0, 2, 4)] == [0, 96, 192]
+    for i in (0, 2, 4):
+        assert arena.buffer.read(96, views[i].offset) == bytes([i]) * 96
+    assert arena.stats()["fragments"] == 1
+    assert arena.stats()["largest_free"] == 1024 - 288
+    assert arena.defragment() == []
+
+
+def test_buffer_arena_render(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    vertex_arena = ctx.buffer_arena(4096)
+    index_arena = ctx.buffer_arena(1024, index=True)
+    red = np.array([[-1.0, -1.0, 1.0, 0.0, 0.0], [0.2, -1.0, 1.0, 0.0, 0.0], [-1.0, 0.2, 1.0, 0.0, 0.0]], "f4")
+    green = np.array([[1.0, 1.0, 0.0, 1.0, 0.0], [-0.2, 1.0, 0.0, 1.0, 0.0], [1.0, -0.2, 0.0, 1.0, 0.0]], "f4")
+    vertex_arena.allocate(size=20)
+    red_vertices = vertex_arena.allocate(red, align=20)
+    green_vertices = vertex_arena.allocate(green, align=20)
+    index_arena.allocate(size=8)
+    red_indices = index_arena.allocate(np.array([0, 1, 2], "i4"))
+    green_indices = index_arena.allocate(np.array([0, 1, 2], "i4"))
+
+    vertex_shader = """
+        #version 330 core
+
+        layout (location = 0) in vec2 in_vertex;
+        layout (location = 1) in vec3 in_color;
+
+        out vec3 v_color;
+
+        void main() {
+            v_color = in_color;
+            gl_Position = vec4(in_vertex, 0.0, 1.0);
+        }
+    """
+
+    fragment_shader = """
+        #version 330 core
+
+        in vec3 v_color;
+
+        layout (location = 0) out vec4 out_color;
+
+        void main() {
+            out_color = vec4(v_color, 1.0);
+        }
+    """
+
+    red_pipeline = ctx.pipeline(
+        vertex_shader=vertex_shader,
+        fragment_shader=fragment_shader,
+        framebuffer=[image],
+        vertex_buffers=zengl.bind(red_vertices, "2f 3f", 0, 1),
+        index_buffer=red_indices,
+        vertex_count=3,
+    )
+
+    green_pipeline = ctx.pipeline(
+        vertex_shader=vertex_shader,
+        fragment_shader=fragment_shader,
+        framebuffer=[image],
+        vertex_buffers=zengl.bind(vertex_arena.buffer, "2f 3f", 0, 1),
+        index_buffer=index_arena.buffer,
+        vertex_count=3,
+        first_vertex=green_indices.offset // 4,
+        base_vertex=green_vertices.offset // 20,
+    )
+
+    ctx.new_frame()
+    image.clear()
+    red_pipeline.render()
+    green_pipeline.render()
+    ctx.end_frame()
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 16, 48, 48], [16, 48, 16, 48]],
+        [
+            [255, 0, 0, 255],
+            [0, 0, 0, 0],
+            [0, 0, 0, 0],
+            [0, 255, 0, 255],
+        ],
+    )
+
+
+def test_buffer_arena_index_offset(ctx: zengl.Context):
+    image = ctx.image((4, 4), "rgba8unorm")
+    index_arena = ctx.buffer_arena(64, index=True)
+    index_arena.allocate(size=2)
+    view = index_arena.allocate(size=6, align=2)
+    with pytest.raises(ValueError):
+        ctx.pipeline(
+            vertex_shader="#version 330 core\nvoid main() {}",
+            fragment_shader="#version 330 core\nvoid main() {}",
+            framebuffer=[image],
+            index_buffer=view,
+            vertex_count=3,
+        )
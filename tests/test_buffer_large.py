@@ -0,0 +1,31 @@
+import sys
+
+import pytest
+import zengl
+
+LARGE_SIZE = 0x80000000 + 0x1000
+
+pytestmark = pytest.mark.skipif(sys.maxsize < LARGE_SIZE, reason="requires a 64-bit build")
+
+
+def test_buffer_large_offsets(ctx: zengl.Context):
+    buffer = ctx.buffer(size=LARGE_SIZE)
+    assert buffer.size == LARGE_SIZE
+    buffer.write(b"abcdefgh", offset=0x80000000)
+    assert buffer.read(8, 0x80000000) == b"abcdefgh"
+    view = buffer.view(8, 0x80000000)
+    assert (view.offset, view.size) == (0x80000000, 8)
+    target = ctx.buffer(size=16)
+    target.write(view, offset=4)
+    assert target.read(8, 4) == b"abcdefgh"
+    ctx.release(buffer)
+
+
+def test_buffer_arena_large_offsets(ctx: zengl.Context):
+    arena = ctx.buffer_arena(LARGE_SIZE)
+    arena.allocate(size=0x80000000)
+    view = arena.allocate(b"ijklmnop")
+    assert view.offset == 0x80000000
+    assert arena.buffer.read(8, view.offset) == b"ijklmnop"
+    assert arena.stats()["used"] == 0x80000008
+    ctx.release(arena.buffer)
@@ -0,0 +1,91 @@
+import numpy as np
+import pytest
+import zengl
+
+
+def test_buffer_map(ctx: zengl.Context):
+    buffer = ctx.buffer(size=64, access="stream_persistent")
+    assert buffer.persistent
+    mem = buffer.map()
+    assert len(mem) == 64
+    mem[0:8] = b"abcdefgh"
+    assert buffer.read(8) == b"abcdefgh"
+    buffer.write(b"ijkl", offset=4)
+    assert bytes(mem[0:8]) == b"abcdijkl"
+
+
+def test_buffer_map_not_persistent(ctx: zengl.Context):
+    buffer = ctx.buffer(size=64)
+    assert not buffer.persistent
+    with pytest.raises(RuntimeError):
+        buffer.map()
+    with pytest.raises(TypeError):
+        buffer.stream(b"abcd")
+
+
+def test_buffer_stream_ring(ctx: zengl.Context):
+    buffer = ctx.buffer(size=1024, access="stream_persistent")
+    offsets = []
+    for frame in range(10):
+        ctx.new_frame()
+        data = bytes([frame]) * 300
+        view = buffer.stream(data, align=256)
+        assert view.buffer is buffer
+        assert view.size == 300
+        assert view.offset % 256 == 0
+        assert buffer.read(300, view.offset) == data
+        offsets.append(view.offset)
+        ctx.end_frame()
+    assert offsets[:4] == [0, 512, 0, 512]
+
+
+def test_buffer_stream_reserve(ctx: zengl.Context):
+    buffer = ctx.buffer(size=256, access="stream_persistent")
+    ctx.new_frame()
+    first = buffer.stream(size=16)
+    second = buffer.stream(size=16, align=64)
+    assert (first.offset, second.offset) == (0, 64)
+    buffer.map()[second.offset : second.offset + 4] = b"wxyz"
+    assert buffer.read(4, 64) == b"wxyz"
+    ctx.end_frame()
+
+
+def test_buffer_stream_too_small(ctx: zengl.Context):
+    buffer = ctx.buffer(size=256, access="stream_persistent")
+    ctx.new_frame()
+    with pytest.raises(ValueError):
+        buffer.stream(size=512)
+    buffer.stream(size=200)
+    with pytest.raises(ValueError):
+        buffer.stream(size=100)
+    ctx.end_frame()
+
+
+def test_buffer_stream_image_upload(ctx: zengl.Context):
+    image = ctx.image((4, 4), "rgba8unorm")
+    buffer = ctx.buffer(size=1024, access="stream_persistent")
+    for color in [(255, 0, 0, 255), (0, 255, 0, 255), (0, 0, 255, 255)]:
+        ctx.new_frame()
+        image.write(buffer.stream(bytes(color) * 16, align=4))
+        pixels = np.frombuffer(image.read(), "u1").reshape(16, 4)
+        np.testing.assert_array_equal(pixels, np.full((16, 4), color))
+        ctx.end_frame()
+
+
+def test_buffer_map_release(ctx: zengl.Context):
+    buffer = ctx.buffer(size=64, access="stream_persistent")
+    mem = buffer.map()
+    view = mem[8:16]
+    with pytest.raises(BufferError):
+        ctx.release(buffer)
+    with pytest.raises(BufferError):
+        ctx.release("all")
+    view[0:4] = b"abcd"
+    assert buffer.read(4, 8) == b"abcd"
+    del mem
+    with pytest.raises(BufferError):
+        ctx.release(buffer)
+    view.release()
+    ctx.release(buffer)
+    with pytest.raises(RuntimeError):
+        buffer.map()
@@ -0,0 +1,92 @@
+import numpy as np
+import zengl
+
+
+def make_texture(ctx, color):
+    return ctx.image((4, 4), "rgba8unorm", np.full((4, 4, 4), color, "u1"))
+
+
+def make_pipeline(ctx, image, viewport, shared, material):
+    return ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            uniform sampler2D Shared;
+            uniform sampler2D Material;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = texture(Shared, vec2(0.5, 0.5)) + texture(Material, vec2(0.5, 0.5));
+            }
+        """,
+        layout=[
+            {
+                "name": "Shared",
+                "binding": 0,
+            },
+            {
+                "name": "Material",
+                "binding": 1,
+            },
+        ],
+        resources=[
+            {
+                "type": "sampler",
+                "binding": 0,
+                "image": shared,
+            },
+            {
+                "type": "sampler",
+                "binding": 1,
+                "image": material,
+            },
+        ],
+        framebuffer=[image],
+        viewport=viewport,
+        topology="triangles",
+        vertex_count=3,
+    )
+
+
+def test_descriptor_set_slots(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    shared = make_texture(ctx, (0, 0, 255, 255))
+    red = make_texture(ctx, (255, 0, 0, 0))
+    green = make_texture(ctx, (0, 255, 0, 0))
+    left = make_pipeline(ctx, image, (0, 0, 32, 64), shared, red)
+    right = make_pipeline(ctx, image, (32, 0, 32, 64), shared, green)
+
+    ctx.new_frame()
+    image.clear()
+    ctx.render([left, right, left, right])
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(pixels[32, [16, 48]], [[255, 0, 255, 255], [0, 255, 255, 255]])
+
+    ctx.release(right)
+    ctx.release(green)
+    yellow = make_texture(ctx, (255, 255, 0, 0))
+    right = make_pipeline(ctx, image, (32, 0, 32, 64), shared, yellow)
+
+    ctx.new_frame(reset=False)
+    image.clear()
+    right.render()
+    ctx.end_frame(clean=False)
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(pixels[32, 48], [255, 255, 255, 255])
@@ -0,0 +1,109 @@
+import struct
+
+import numpy as np
+import pytest
+import zengl
+
+import utils
+
+
+def read_pixels(image):
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    return pixels[[16, 16, 48, 48], [16, 48, 16, 48]]
+
+
+def test_draw_queue_sort(ctx: zengl.Context):
+    first = ctx.image((64, 64), "rgba8unorm")
+    second = ctx.image((64, 64), "rgba8unorm")
+    queue = ctx.draw_queue()
+    queue.add(utils.make_color_pipeline(ctx, first, (0, 0, 32, 32), (1.0, 0.0, 0.0)))
+    queue.add(utils.make_color_pipeline(ctx, second, (0, 0, 32, 32), (0.0, 1.0, 0.0)))
+    queue.add(utils.make_color_pipeline(ctx, first, (32, 0, 32, 32), (0.0, 0.0, 1.0)))
+    queue.add(utils.make_color_pipeline(ctx, second, (32, 0, 32, 32), (1.0, 1.0, 1.0)))
+    assert len(queue) == 4
+
+    ctx.new_frame()
+    first.clear()
+    second.clear()
+    queue.flush()
+    ctx.end_frame()
+
+    assert len(queue) == 0
+    assert queue.saved_binds == 2
+    np.testing.assert_array_equal(
+        read_pixels(first),
+        [
+            [255, 0, 0, 255],
+            [0, 0, 255, 255],
+            [0, 0, 0, 0],
+            [0, 0, 0, 0],
+        ],
+    )
+    np.testing.assert_array_equal(
+        read_pixels(second),
+        [
+            [0, 255, 0, 255],
+            [255, 255, 255, 255],
+            [0, 0, 0, 0],
+            [0, 0, 0, 0],
+        ],
+    )
+
+
+@pytest.mark.parametrize("sort, color", [(True, [255, 0, 0, 255]), (False, [0, 255, 0, 255])])
+def test_draw_queue_depth(ctx: zengl.Context, sort, color):
+    image = ctx.image((64, 64), "rgba8unorm")
+    red = utils.make_color_pipeline(ctx, image, (0, 0, 64, 64), (1.0, 0.0, 0.0))
+    green = utils.make_color_pipeline(ctx, image, (0, 0, 64, 64), (0.0, 1.0, 0.0))
+    queue = ctx.draw_queue(sort=sort)
+    queue.add(red, depth=2.0)
+    queue.add(green, depth=1.0)
+
+    ctx.new_frame()
+    image.clear()
+    queue.flush()
+    ctx.end_frame()
+
+    assert queue.saved_binds == 0
+    np.testing.assert_array_equal(read_pixels(image), [color] * 4)
+
+
+def test_draw_queue_records_pipeline_state(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = utils.make_color_pipeline(ctx, image, (0, 0, 32, 32), (1.0, 0.0, 0.0))
+    queue = ctx.draw_queue(sort=False)
+    queue.add(pipeline)
+    pipeline.uniforms["color"][:] = struct.pack("3f", 0.0, 0.0, 1.0)
+    pipeline.viewport = (32, 32, 32, 32)
+    queue.add(pipeline)
+    pipeline.uniforms["color"][:] = struct.pack("3f", 0.0, 1.0, 0.0)
+    pipeline.vertex_count = 0
+
+    ctx.new_frame()
+    image.clear()
+    queue.flush()
+    ctx.end_frame()
+
+    np.testing.assert_array_equal(
+        read_pixels(image),
+        [
+            [255, 0, 0, 255],
+            [0, 0, 0, 0],
+            [0, 0, 0, 0],
+            [0, 0, 255, 255],
+        ],
+    )
+
+
+def test_draw_queue_invalid(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = utils.make_color_pipeline(ctx, image, (0, 0, 64, 64), (1.0, 1.0, 1.0))
+    queue = ctx.draw_queue()
+
+    with pytest.raises(TypeError):
+        queue.add(None)
+
+    queue.add(pipeline)
+    queue.clear()
+    assert len(queue) == 0
+    queue.flush()
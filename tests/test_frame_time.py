@@ -51,3 +51,24 @@ def test_frame_time(ctx: zengl.Context):
     ctx.end_frame()
 
     assert ctx.frame_time == 0.0
+
+
+def test_frame_time_without_sync(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+
+    frame_times = []
+    for _ in range(8):
+        ctx.new_frame(frame_time=True)
+        image.clear()
+        ctx.end_frame()
+        frame_times.append(ctx.frame_time)
+        assert 0 <= ctx.frame_time_latency < 4
+
+    assert frame_times[-1] > 0
+
+    for _ in range(4):
+        ctx.new_frame()
+        image.clear()
+        ctx.end_frame()
+
+    assert ctx.frame_time == 0
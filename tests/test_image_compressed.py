@@ -0,0 +1,113 @@
+import struct
+
+import numpy as np
+import pytest
+import zengl
+
+
+def bc1_block(color):
+    return struct.pack("<HHI", color, 0, 0)
+
+
+def render_texels(ctx: zengl.Context, texture: zengl.Image):
+    image = ctx.image(texture.size, "rgba8unorm")
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            uniform sampler2D Texture;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = texelFetch(Texture, ivec2(gl_FragCoord.xy), 0);
+            }
+        """,
+        layout=[{"name": "Texture", "binding": 0}],
+        resources=[{"type": "sampler", "binding": 0, "image": texture, "min_filter": "nearest", "mag_filter": "nearest"}],
+        framebuffer=[image],
+        vertex_count=3,
+    )
+    image.clear()
+    pipeline.render()
+    width, height = texture.size
+    return np.frombuffer(image.read(), "u1").reshape(height, width, 4)
+
+
+@pytest.fixture
+def bc1(ctx: zengl.Context):
+    if "bc1-rgba-unorm" not in ctx.info["compressed_formats"]:
+        pytest.skip("bc1 is not supported")
+
+
+def test_compressed_formats_info(ctx: zengl.Context):
+    assert isinstance(ctx.info["compressed_formats"], tuple)
+
+
+def test_compressed_formats_info_is_not_used_for_validation(ctx: zengl.Context, bc1):
+    compressed_formats = ctx.info.pop("compressed_formats")
+    try:
+        ctx.image((4, 4), "bc1-rgba-unorm")
+    finally:
+        ctx.info["compressed_formats"] = compressed_formats
+
+
+def test_compressed_image_write(ctx: zengl.Context, bc1):
+    red, green, blue, white = 0xF800, 0x07E0, 0x001F, 0xFFFF
+    data = b"".join(bc1_block(x) for x in [red, green, blue, white])
+    texture = ctx.image((8, 8), "bc1-rgba-unorm", data)
+    pixels = render_texels(ctx, texture)
+    np.testing.assert_array_equal(
+        pixels[[0, 0, 7, 7], [0, 7, 0, 7]],
+        [
+            [255, 0, 0, 255],
+            [0, 255, 0, 255],
+            [0, 0, 255, 255],
+            [255, 255, 255, 255],
+        ],
+    )
+
+    texture.write(bc1_block(green), (4, 4), (4, 4))
+    pixels = render_texels(ctx, texture)
+    np.testing.assert_array_equal(pixels[7, 7], [0, 255, 0, 255])
+    np.testing.assert_array_equal(pixels[0, 0], [255, 0, 0, 255])
+
+
+def test_compressed_image_partial_blocks(ctx: zengl.Context, bc1):
+    texture = ctx.image((6, 6), "bc1-rgba-unorm", bc1_block(0x001F) * 4)
+    pixels = render_texels(ctx, texture)
+    np.testing.assert_array_equal(pixels.reshape(36, 4), np.full((36, 4), (0, 0, 255, 255)))
+    texture.write(bc1_block(0xF800), (2, 2), (4, 4))
+    with pytest.raises(ValueError):
+        texture.write(bc1_block(0xF800), (2, 2), (2, 2))
+
+
+def test_compressed_image_errors(ctx: zengl.Context, bc1):
+    texture = ctx.image((8, 8), "bc1-rgba-unorm")
+    with pytest.raises(ValueError):
+        texture.write(bc1_block(0xF800), (4, 4), (2, 0))
+    with pytest.raises(ValueError):
+        texture.write(bc1_block(0xF800), (4, 4), (0, 2))
+    with pytest.raises(ValueError):
+        texture.write(bc1_block(0xF800) * 3)
+    with pytest.raises(TypeError):
+        texture.clear()
+    with pytest.raises(TypeError):
+        texture.read()
+    with pytest.raises(TypeError):
+        texture.mipmaps()
+    with pytest.raises(TypeError):
+        ctx.image((8, 8), "bc1-rgba-unorm", samples=4)
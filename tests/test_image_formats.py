@@ -1,3 +1,6 @@
+import struct
+
+import pytest
 import zengl
 
 import utils
@@ -33,6 +36,14 @@ IMAGE_FORMATS = [
     "r32float",
     "rg32float",
     "rgba32float",
+    "rgb10a2unorm",
+    "rg11b10ufloat",
+    "rgba8unorm-srgb",
+    "rgba4unorm",
+    "rgb565unorm",
+    "r16unorm",
+    "rg16unorm",
+    "rgba16unorm",
     "depth16unorm",
     "depth24plus",
     "depth24plus-stencil8",
@@ -40,9 +51,14 @@ IMAGE_FORMATS = [
 ]
 
 
+TEXTURE_ONLY_IMAGE_FORMATS = [
+    "rgb9e5ufloat",
+]
+
+
 def test_texture_image_formats(ctx: zengl.Context):
     utils.clear_gl_error()
-    for fmt in IMAGE_FORMATS:
+    for fmt in IMAGE_FORMATS + TEXTURE_ONLY_IMAGE_FORMATS:
         img = ctx.image((4, 4), fmt, texture=True)
         utils.assert_gl_error(fmt)
         ctx.release(img)
@@ -56,3 +72,94 @@ def test_renderbuffer_image_formats(ctx: zengl.Context):
         utils.assert_gl_error(fmt)
         ctx.release(img)
         utils.assert_gl_error()
+
+
+def test_texture_only_image_formats(ctx: zengl.Context):
+    for fmt in TEXTURE_ONLY_IMAGE_FORMATS:
+        with pytest.raises(TypeError):
+            ctx.image((4, 4), fmt, texture=False)
+
+
+def test_extension_image_formats(ctx: zengl.Context):
+    assert isinstance(ctx.info["extension_formats"], tuple)
+    for fmt in ("r16unorm", "rg16unorm", "rgba16unorm"):
+        if fmt in ctx.info["extension_formats"]:
+            ctx.release(ctx.image((4, 4), fmt))
+        else:
+            with pytest.raises(ValueError):
+                ctx.image((4, 4), fmt)
+
+
+@pytest.mark.parametrize(
+    "fmt, clear_value, pixel",
+    [
+        ("rg11b10ufloat", (0.5, 0.25, 1.0), struct.pack("<I", 0x781A0380)),
+        ("rgba8unorm-srgb", (0.5, 0.25, 1.0, 1.0), bytes([188, 137, 255, 255])),
+        ("rgba4unorm", (0.5, 0.25, 1.0, 1.0), struct.pack("<H", 0x84FF)),
+        ("rgb565unorm", (0.5, 0.25, 1.0), struct.pack("<H", 0x821F)),
+        ("r16unorm", 0.5, struct.pack("<H", 0x8000)),
+        ("rg16unorm", (0.5, 0.25), struct.pack("<HH", 0x8000, 0x4000)),
+        ("rgba16unorm", (0.5, 0.25, 1.0, 1.0), struct.pack("<HHHH", 0x8000, 0x4000, 0xFFFF, 0xFFFF)),
+    ],
+)
+def test_packed_image_formats_clear_and_read(ctx: zengl.Context, fmt, clear_value, pixel):
+    for texture in (True, False):
+        img = ctx.image((4, 4), fmt, texture=texture)
+        img.clear_value = clear_value
+        img.clear()
+        assert img.read() == pixel * 16
+        img.write(pixel * 4, (2, 2), (1, 1))
+        assert img.read((2, 2), (1, 1)) == pixel * 4
+
+
+def test_srgb_screen_blit_is_not_encoded(ctx: zengl.Context):
+    screen = ctx.image((4, 4), "rgba8unorm-srgb")
+    image = ctx.image((4, 4), "rgba8unorm", bytes([128, 64, 255, 255]) * 16)
+    ctx.screen = zengl.inspect(screen.face(0))["framebuffer"]
+    image.blit()
+    ctx.screen = 0
+    assert screen.read() == bytes([128, 64, 255, 255]) * 16
+    screen.clear_value = (0.5, 0.25, 1.0, 1.0)
+    screen.clear()
+    assert screen.read() == bytes([188, 137, 255, 255]) * 16
+
+
+def test_shared_exponent_image_format(ctx: zengl.Context):
+    texture = ctx.image((4, 4), "rgb9e5ufloat")
+    texture.clear_value = (0.5, 0.25, 4.0)
+    texture.clear()
+    image = ctx.image((4, 4), "rgba32float")
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            uniform sampler2D Texture;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = texelFetch(Texture, ivec2(gl_FragCoord.xy), 0);
+            }
+        """,
+        layout=[{"name": "Texture", "binding": 0}],
+        resources=[{"type": "sampler", "binding": 0, "image": texture, "min_filter": "nearest", "mag_filter": "nearest"}],
+        framebuffer=[image],
+        vertex_count=3,
+    )
+    pipeline.render()
+    assert struct.unpack("4f", image.read((1, 1))) == (0.5, 0.25, 4.0, 1.0)
+    with pytest.raises(TypeError):
+        texture.read()
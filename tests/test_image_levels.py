@@ -0,0 +1,86 @@
+import numpy as np
+import pytest
+import zengl
+
+
+def mip_chain(size, layers=1, pixel=4):
+    chunks = []
+    width, height = size
+    level = 0
+    while True:
+        row = (width * pixel + 3) & ~3
+        chunks.append(bytes([level * 16 + layer for layer in range(layers) for _ in range(row * height)]))
+        if width == 1 and height == 1:
+            break
+        width, height = max(width // 2, 1), max(height // 2, 1)
+        level += 1
+    return chunks
+
+
+def test_write_all_levels(ctx: zengl.Context):
+    chain = mip_chain((16, 8))
+    img = ctx.image((16, 8), "rgba8unorm", levels=5)
+    img.write(b"".join(chain), levels="all")
+    assert len(chain) == 5
+    for level, data in enumerate(chain):
+        assert img.face(level=level).read() == data
+    assert img.read(levels="all") == b"".join(chain)
+
+
+def test_write_levels_from_buffer(ctx: zengl.Context):
+    chain = b"".join(mip_chain((8, 8)))
+    buf = ctx.buffer(chain)
+    img = ctx.image((8, 8), "rgba8unorm", levels=4)
+    img.write(buf, levels="all")
+    assert img.read(levels="all") == chain
+
+    target = ctx.buffer(size=len(chain) + 16)
+    img.read(into=target.view(len(chain), 16), levels="all")
+    assert target.read(len(chain), 16) == chain
+
+
+def test_write_partial_levels(ctx: zengl.Context):
+    img = ctx.image((8, 8), "rgba8unorm", levels=4)
+    chain = mip_chain((8, 8))
+    img.write(b"".join(chain[1:3]), level=1, levels=2)
+    assert img.read(levels=3)[256:] == b"".join(chain[1:3])
+
+
+def test_array_levels(ctx: zengl.Context):
+    chain = b"".join(mip_chain((4, 4), layers=3))
+    img = ctx.image((4, 4), "rgba8unorm", array=3, levels=3)
+    img.write(chain, levels="all")
+    assert img.read(levels="all") == chain
+    assert img.face(layer=1, level=1).read() == bytes([17]) * 16
+
+
+def test_cubemap_levels(ctx: zengl.Context):
+    chain = b"".join(mip_chain((4, 4), layers=6))
+    img = ctx.image((4, 4), "rgba8unorm", cubemap=True, levels=3)
+    img.write(chain, levels="all")
+    assert img.read(levels="all") == chain
+
+
+def test_padded_rows_levels(ctx: zengl.Context):
+    chain = b"".join(
+        np.pad(np.full((size, size), level + 1, "u1"), ((0, 0), (0, -size % 4))).tobytes()
+        for level, size in enumerate([6, 3, 1])
+    )
+    img = ctx.image((6, 6), "r8unorm", levels=3)
+    img.write(chain, levels="all")
+    assert img.read(levels="all") == chain
+    assert img.face(level=1).read((1, 1), (2, 2)) == b"\x02"
+
+
+def test_invalid_levels(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm", levels=3)
+    with pytest.raises(ValueError):
+        img.write(b"\x00" * 64, levels=4)
+    with pytest.raises(ValueError):
+        img.write(b"\x00" * 64, levels="all")
+    with pytest.raises(ValueError):
+        img.write(b"\x00" * 16, (2, 2), levels=1)
+    with pytest.raises(TypeError):
+        img.write(b"\x00" * 64, levels="some")
+    with pytest.raises(ValueError):
+        img.read((2, 2), levels="all")
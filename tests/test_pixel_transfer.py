@@ -1,3 +1,4 @@
+import numpy as np
 import pytest
 import zengl
 
@@ -34,3 +35,53 @@ def test_image_read_to_buffer_offset(ctx: zengl.Context):
     buf = ctx.buffer(b"UUUUUUUU" + b"BBBB" * 16 + b"VVVVVVVV")
     img.read(into=buf.view(64, 8))
     assert buf.read() == b"UUUUUUUU" + b"AAAA" * 16 + b"VVVVVVVV"
+
+
+def test_image_write_strided_tile(ctx: zengl.Context):
+    pixels = np.arange(16 * 16 * 4, dtype="u4").astype("u1").reshape(16, 16, 4)
+    img = ctx.image((4, 4), "rgba8unorm")
+    img.write(pixels[4:8, 2:6])
+    assert img.read() == pixels[4:8, 2:6].tobytes()
+
+
+def test_image_write_strided_sub_rectangle(ctx: zengl.Context):
+    pixels = np.arange(10 * 10, dtype="u1").reshape(10, 10)
+    img = ctx.image((8, 8), "r8unorm")
+    img.write(pixels[1:7, 2:8], (6, 6), (1, 1))
+    into = np.zeros((10, 10), "u1")
+    img.read((6, 6), (1, 1), into=into[2:8, 3:9])
+    np.testing.assert_array_equal(into[2:8, 3:9], pixels[1:7, 2:8])
+    assert into[:2].sum() == 0 and into[:, :3].sum() == 0
+
+
+def test_image_write_strided_layers(ctx: zengl.Context):
+    pixels = np.arange(3 * 8 * 8 * 4, dtype="u4").astype("u1").reshape(3, 8, 8, 4)
+    img = ctx.image((4, 4), "rgba8unorm", array=2)
+    img.write(pixels[1:, 2:6, 3:7])
+    assert img.read() == pixels[1:, 2:6, 3:7].tobytes()
+    img.write(pixels[0, :4, :4], layer=1)
+    assert img.face(layer=1).read() == pixels[0, :4, :4].tobytes()
+
+
+def test_image_write_tight_rows(ctx: zengl.Context):
+    pixels = np.arange(6 * 6, dtype="u1").reshape(6, 6)
+    img = ctx.image((6, 6), "r8unorm")
+    img.write(pixels)
+    into = np.zeros((6, 6), "u1")
+    img.read(into=into)
+    np.testing.assert_array_equal(into, pixels)
+    layers = np.arange(2 * 6 * 6, dtype="u1").reshape(2, 6, 6)
+    img = ctx.image((6, 6), "r8unorm", array=2)
+    img.write(layers)
+    for i in range(2):
+        img.face(layer=i).read(into=into)
+        np.testing.assert_array_equal(into, layers[i])
+
+
+def test_image_read_strided(ctx: zengl.Context):
+    pixels = np.arange(4 * 4 * 4, dtype="u1").reshape(4, 4, 4)
+    img = ctx.image((4, 4), "rgba8unorm", pixels)
+    into = np.zeros((8, 8, 4), "u1")
+    img.read(into=into[2:6, 1:5])
+    np.testing.assert_array_equal(into[2:6, 1:5], pixels)
+    assert into.sum() == pixels.sum()
@@ -0,0 +1,76 @@
+import json
+
+import zengl
+
+
+def test_profile(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(0.1, 0.0),
+                vec2(-0.05, 0.086),
+                vec2(-0.05, -0.086)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID] + 0.5, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(0.0, 0.0, 1.0, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="triangles",
+        vertex_count=3,
+    )
+    pipeline.label = "triangle"
+
+    ctx.new_frame()
+    image.clear()
+    pipeline.render()
+    ctx.end_frame(sync=True)
+
+    assert ctx.profile() == []
+
+    ctx.new_frame(profile=True)
+    image.clear()
+    pipeline.render()
+    image.blit()
+    image.read()
+    ctx.end_frame(sync=True)
+
+    events = ctx.profile()
+    assert [event["name"] for event in events] == ["clear", "triangle", "blit", "read"]
+    assert [event["cat"] for event in events] == ["clear", "render", "blit", "read"]
+    assert all(event["ph"] == "X" and event["dur"] >= 0.0 for event in events)
+    assert len({event["args"]["frame"] for event in events}) == 1
+    assert ctx.profile() == []
+
+    json.dumps({"traceEvents": events})
+
+
+def test_profile_without_sync(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+
+    for _ in range(8):
+        ctx.new_frame(profile=True)
+        image.clear()
+        ctx.end_frame()
+
+    ctx.new_frame()
+    ctx.end_frame(sync=True)
+    ctx.new_frame()
+    ctx.end_frame()
+
+    events = ctx.profile()
+    assert [event["args"]["frame"] for event in events] == sorted(event["args"]["frame"] for event in events)
+    assert len(events) == 8
@@ -0,0 +1,107 @@
+import numpy as np
+import pytest
+import zengl
+
+
+def make_pipeline(ctx, image):
+    return ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            uniform vec3 color;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(color, 1.0);
+            }
+        """,
+        uniforms={
+            "color": (0.0, 0.0, 1.0),
+        },
+        framebuffer=[image],
+        topology="triangles",
+        vertex_count=3,
+    )
+
+
+def render(ctx, image):
+    pipeline = make_pipeline(ctx, image)
+    ctx.new_frame()
+    image.clear()
+    pipeline.render()
+    ctx.end_frame()
+    ctx.release(pipeline)
+    ctx.release("shader_cache")
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(pixels[32, 32], [0, 0, 255, 255])
+
+
+@pytest.fixture
+def cache(ctx: zengl.Context, tmp_path):
+    ctx.program_binary_cache = str(tmp_path)
+    yield tmp_path
+    ctx.program_binary_cache = None
+
+
+def test_program_binary_cache(ctx: zengl.Context, cache):
+    image = ctx.image((64, 64), "rgba8unorm")
+
+    render(ctx, image)
+    files = list(cache.iterdir())
+    if not files:
+        pytest.skip("program binaries are not supported")
+
+    assert len(files) == 1
+    stat = files[0].stat()
+    render(ctx, image)
+    assert list(cache.iterdir()) == files
+    assert files[0].stat().st_ino == stat.st_ino
+    assert files[0].stat().st_mtime_ns == stat.st_mtime_ns
+
+
+def test_program_binary_cache_rejected(ctx: zengl.Context, cache):
+    image = ctx.image((64, 64), "rgba8unorm")
+
+    render(ctx, image)
+    files = list(cache.iterdir())
+    if not files:
+        pytest.skip("program binaries are not supported")
+
+    data = bytearray(files[0].read_bytes())
+    data[-16:] = bytes(16)
+    files[0].write_bytes(data)
+    render(ctx, image)
+    assert files[0].read_bytes() != data
+
+    stat = files[0].stat()
+    render(ctx, image)
+    assert files[0].stat().st_ino == stat.st_ino
+    assert files[0].stat().st_mtime_ns == stat.st_mtime_ns
+
+
+def test_program_binary_cache_attribute(ctx: zengl.Context, tmp_path):
+    ctx.program_binary_cache = tmp_path
+    assert ctx.program_binary_cache == str(tmp_path)
+
+    with pytest.raises(TypeError):
+        del ctx.program_binary_cache
+
+    with pytest.raises(TypeError):
+        ctx.program_binary_cache = 1
+
+    ctx.program_binary_cache = None
+    assert ctx.program_binary_cache is None
@@ -0,0 +1,58 @@
+import numpy as np
+import pytest
+import zengl
+
+
+def test_read_async(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm")
+    img.clear_value = (1.0, 0.0, 0.0, 1.0)
+    img.clear()
+    readback = img.read_async()
+    assert readback.size == 64
+    assert readback.result() == b"\xff\x00\x00\xff" * 16
+    assert readback.ready()
+
+    with pytest.raises(ValueError):
+        readback.result()
+
+
+def test_read_async_in_flight(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm")
+    readbacks = []
+    for i in range(3):
+        img.clear_value = (i / 255.0, 0.0, 0.0, 1.0)
+        img.clear()
+        readbacks.append(img.read_async())
+
+    for i, readback in enumerate(readbacks):
+        while not readback.ready():
+            pass
+        into = bytearray(64)
+        readback.result(into=into)
+        assert into == bytes([i, 0, 0, 255]) * 16
+
+
+def test_read_async_face(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm", array=2)
+    img.clear_value = (0.0, 1.0, 0.0, 1.0)
+    img.clear()
+    assert img.face(layer=1).read_async(size=(2, 2), offset=(1, 1)).result() == b"\x00\xff\x00\xff" * 4
+    assert img.read_async().result() == b"\x00\xff\x00\xff" * 32
+
+
+def test_read_async_multisample(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm", samples=4)
+    img.clear_value = (0.0, 0.0, 1.0, 1.0)
+    img.clear()
+    pixels = np.frombuffer(img.read_async().result(), "u1").reshape(4, 4, 4)
+    np.testing.assert_array_equal(pixels, np.full((4, 4, 4), (0, 0, 255, 255)))
+
+
+def test_read_async_invalid_into(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm")
+    readback = img.read_async()
+
+    with pytest.raises(ValueError):
+        readback.result(into=bytearray(16))
+
+    readback.result(into=bytearray(64))
@@ -1,3 +1,4 @@
+import pytest
 import zengl
 
 
@@ -6,3 +7,34 @@ def test_read_multisampled_image(ctx: zengl.Context):
     img.clear_value = (0.0, 1.0, 0.0, 1.0)
     img.clear()
     assert img.read() == b"\x00\xff\x00\xff" * 16
+
+
+def test_read_multisampled_image_region(ctx: zengl.Context):
+    img = ctx.image((8, 8), "rgba8unorm", samples=4)
+    img.clear_value = (1.0, 0.0, 0.0, 1.0)
+    img.clear()
+    assert img.read((2, 2), (4, 4)) == b"\xff\x00\x00\xff" * 4
+    assert img.read() == b"\xff\x00\x00\xff" * 64
+    assert img.read((3, 1)) == b"\xff\x00\x00\xff" * 3
+
+
+def test_resolve_multisampled_image(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm", samples=4)
+    img.clear_value = (0.0, 0.0, 1.0, 1.0)
+    img.clear()
+    resolved = img.resolve()
+    assert resolved.samples == 1
+    assert resolved.size == (4, 4)
+    assert resolved.read() == b"\x00\x00\xff\xff" * 16
+    assert img.resolve() is resolved
+    img.read()
+    assert img.resolve() is resolved
+    with pytest.raises(ValueError):
+        ctx.release(resolved)
+    ctx.release(img)
+
+
+def test_resolve_single_sampled_image(ctx: zengl.Context):
+    img = ctx.image((4, 4), "rgba8unorm")
+    with pytest.raises(TypeError):
+        img.resolve()
@@ -0,0 +1,243 @@
+import sys
+import threading
+import time
+
+import zengl
+
+
+def count_while(callback):
+    state = {"running": True, "count": 0}
+
+    def worker():
+        while state["running"]:
+            state["count"] += 1
+            time.sleep(0)
+
+    switch_interval = sys.getswitchinterval()
+    sys.setswitchinterval(10.0)
+    thread = threading.Thread(target=worker)
+    thread.start()
+    try:
+        time.sleep(0.01)
+        before = state["count"]
+        callback()
+        progress = state["count"] - before
+    finally:
+        state["running"] = False
+        thread.join()
+        sys.setswitchinterval(switch_interval)
+    return progress
+
+
+def test_read_releases_gil(ctx: zengl.Context):
+    image = ctx.image((1024, 1024), "rgba8unorm")
+    image.clear_value = (0.25, 0.5, 0.75, 1.0)
+    image.clear()
+
+    def read():
+        for _ in range(20):
+            image.read()
+
+    assert count_while(read) > 0
+
+
+def test_buffer_read_releases_gil(ctx: zengl.Context):
+    buffer = ctx.buffer(size=0x400000)
+
+    def read():
+        for _ in range(20):
+            buffer.read()
+
+    assert count_while(read) > 0
+
+
+def test_write_releases_gil(ctx: zengl.Context):
+    image = ctx.image((1024, 1024), "rgba8unorm")
+    data = bytes(1024 * 1024 * 4)
+
+    def write():
+        for _ in range(20):
+            image.write(data)
+
+    assert count_while(write) > 0
+
+
+def test_sync_releases_gil(ctx: zengl.Context):
+    image = ctx.image((1024, 1024), "rgba8unorm")
+
+    def sync():
+        for _ in range(20):
+            ctx.new_frame()
+            image.clear()
+            ctx.end_frame(sync=True)
+
+    assert count_while(sync) > 0
+
+
+def test_draw_queue_flush_releases_gil(ctx: zengl.Context):
+    image = ctx.image((1024, 1024), "rgba8unorm")
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(0.0, 0.0, 1.0, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="triangles",
+        vertex_count=3,
+    )
+
+    queue = ctx.draw_queue()
+
+    def flush():
+        for _ in range(20):
+            for _ in range(100):
+                queue.add(pipeline)
+            queue.flush()
+
+    assert count_while(flush) > 0
+
+
+def test_draw_queue_flush_rejects_context_calls(ctx: zengl.Context):
+    image = ctx.image((1024, 1024), "rgba8unorm")
+    buffer = ctx.buffer(size=16)
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(0.0, 0.0, 1.0, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="triangles",
+        vertex_count=3,
+    )
+
+    queue = ctx.draw_queue()
+    state = {"running": True, "busy": 0}
+
+    # the calls below are invalid when the context is idle, so the worker never issues a GL call
+    def worker():
+        while state["running"]:
+            for call in (lambda: buffer.write(b"", offset=-1), lambda: ctx.pipeline(), lambda: image.write(b"", size=(0, 0))):
+                try:
+                    call()
+                except RuntimeError:
+                    state["busy"] += 1
+                except (ValueError, TypeError):
+                    pass
+            time.sleep(0)
+
+    thread = threading.Thread(target=worker)
+    thread.start()
+    try:
+        for _ in range(100):
+            for _ in range(100):
+                queue.add(pipeline)
+            queue.flush()
+            if state["busy"]:
+                break
+    finally:
+        state["running"] = False
+        thread.join()
+
+    assert state["busy"] > 0
+    pipeline.render()
+    buffer.write(b"\x00" * 16)
+
+
+def test_draw_queue_flush_defers_readback_release(ctx: zengl.Context):
+    image = ctx.image((1024, 1024), "rgba8unorm")
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(0.0, 0.0, 1.0, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="triangles",
+        vertex_count=3,
+    )
+
+    small = ctx.image((4, 4), "rgba8unorm")
+    readbacks = [small.read_async() for _ in range(64)]
+    queue = ctx.draw_queue()
+    started = threading.Event()
+
+    # the readbacks are dropped on another thread, their fences and buffers must outlive the flush
+    def worker():
+        started.wait()
+        while readbacks:
+            readbacks.pop()
+            time.sleep(0)
+
+    thread = threading.Thread(target=worker)
+    thread.start()
+    try:
+        for _ in range(100):
+            for _ in range(100):
+                queue.add(pipeline)
+            started.set()
+            queue.flush()
+            if not readbacks:
+                break
+    finally:
+        readbacks.clear()
+        started.set()
+        thread.join()
+
+    ctx.end_frame()
+    ctx.new_frame()
+    small.clear_value = (1.0, 0.0, 0.0, 1.0)
+    small.clear()
+    assert small.read_async().result() == b"\xff\x00\x00\xff" * 16
@@ -0,0 +1,151 @@
+import numpy as np
+import pytest
+import zengl
+
+
+def test_render_base_vertex(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    vertex_buffer = ctx.buffer(
+        np.array(
+            [
+                [-1.0, -1.0],
+                [0.0, -1.0],
+                [-1.0, 0.0],
+                [0.0, 0.0],
+                [1.0, 0.0],
+                [0.0, 1.0],
+            ],
+            "f4",
+        )
+    )
+    index_buffer = ctx.buffer(np.array([0, 1, 2], "i4"), index=True)
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            layout (location = 0) in vec2 in_vertex;
+
+            void main() {
+                gl_Position = vec4(in_vertex, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(1.0, 1.0, 1.0, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="triangles",
+        vertex_buffers=zengl.bind(vertex_buffer, "2f", 0),
+        index_buffer=index_buffer,
+        vertex_count=3,
+        base_vertex=3,
+    )
+
+    ctx.new_frame()
+    image.clear()
+    pipeline.render()
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[8, 40], [8, 40]],
+        [
+            [0, 0, 0, 0],
+            [255, 255, 255, 255],
+        ],
+    )
+
+
+def test_render_base_instance(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    instance_buffer = ctx.buffer(np.array([[1.0, 0.0, 0.0], [0.0, 1.0, 0.0]], "f4"))
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            layout (location = 0) in vec3 in_color;
+
+            out vec3 v_color;
+
+            void main() {
+                v_color = in_color;
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            in vec3 v_color;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(v_color, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="triangles",
+        vertex_buffers=zengl.bind(instance_buffer, "3f /i", 0),
+        vertex_count=3,
+    )
+
+    ctx.new_frame()
+    image.clear()
+    pipeline.render()
+    pipeline.base_instance = 1
+    pipeline.render()
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(pixels[32, 32], [0, 255, 0, 255])
+
+
+def test_base_draws_not_supported(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            void main() {
+                gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(1.0, 1.0, 1.0, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="points",
+        vertex_count=1,
+    )
+
+    with pytest.raises(TypeError):
+        pipeline.base_vertex = None
+
+    for name, record in (("base_vertex", [1, 1, 0, 1, 0]), ("base_instance", [1, 1, 0, 0, 1])):
+        try:
+            setattr(pipeline, name, 1)
+        except ValueError:
+            assert getattr(pipeline, name) == 0
+            with pytest.raises(ValueError):
+                pipeline.render_multi(np.array(record, "i4"))
+        else:
+            assert getattr(pipeline, name) == 1
+            pipeline.render_multi(np.array(record, "i4"))
+            setattr(pipeline, name, 0)
@@ -0,0 +1,44 @@
+import numpy as np
+import pytest
+import zengl
+
+import utils
+
+
+def test_render_batch(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipelines = [
+        utils.make_color_pipeline(ctx, image, (0, 0, 32, 32), (1.0, 0.0, 0.0)),
+        utils.make_color_pipeline(ctx, image, (32, 0, 32, 32), (0.0, 1.0, 0.0)),
+        utils.make_color_pipeline(ctx, image, (0, 32, 32, 32), (0.0, 0.0, 1.0)),
+    ]
+
+    ctx.new_frame()
+    image.clear()
+    ctx.render(pipelines)
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 16, 48, 48], [16, 48, 16, 48]],
+        [
+            [255, 0, 0, 255],
+            [0, 255, 0, 255],
+            [0, 0, 255, 255],
+            [0, 0, 0, 0],
+        ],
+    )
+
+
+def test_render_batch_invalid(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = utils.make_color_pipeline(ctx, image, (0, 0, 64, 64), (1.0, 1.0, 1.0))
+
+    with pytest.raises(TypeError):
+        ctx.render(pipeline)
+
+    with pytest.raises(TypeError):
+        ctx.render([pipeline, None])
+
+    ctx.render([])
+    ctx.render((pipeline,))
@@ -0,0 +1,159 @@
+import struct
+
+import numpy as np
+import pytest
+import zengl
+
+
+def make_pipeline(ctx, image, arena):
+    return ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            layout (std140) uniform Object {
+                vec4 offset;
+                vec4 color;
+            };
+
+            vec2 positions[4] = vec2[](
+                vec2(-0.5, -0.5),
+                vec2(0.5, -0.5),
+                vec2(-0.5, 0.5),
+                vec2(0.5, 0.5)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID] + offset.xy, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (std140) uniform Object {
+                vec4 offset;
+                vec4 color;
+            };
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = color;
+            }
+        """,
+        layout=[
+            {
+                "name": "Object",
+                "binding": 0,
+            },
+        ],
+        resources=[
+            {
+                "type": "uniform_buffer",
+                "binding": 0,
+                "buffer": arena,
+                "size": 32,
+                "dynamic": True,
+            },
+        ],
+        framebuffer=[image],
+        topology="triangle_strip",
+        vertex_count=4,
+    )
+
+
+def test_dynamic_uniform_buffer(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    arena = ctx.buffer(size=0x10000, uniform=True, access="stream_persistent")
+    pipeline = make_pipeline(ctx, image, arena)
+
+    objects = [
+        ((-0.5, -0.5), (1.0, 0.0, 0.0, 1.0)),
+        ((0.5, -0.5), (0.0, 1.0, 0.0, 1.0)),
+        ((-0.5, 0.5), (0.0, 0.0, 1.0, 1.0)),
+        ((0.5, 0.5), (1.0, 1.0, 1.0, 1.0)),
+    ]
+
+    ctx.new_frame()
+    image.clear()
+    for offset, color in objects:
+        view = arena.stream(struct.pack("4f4f", *offset, 0.0, 0.0, *color))
+        assert view.offset % ctx.info["uniform_buffer_offset_alignment"] == 0
+        pipeline.dynamic_offset = view.offset
+        pipeline.render()
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 16, 48, 48], [16, 48, 16, 48]],
+        [
+            [255, 0, 0, 255],
+            [0, 255, 0, 255],
+            [0, 0, 255, 255],
+            [255, 255, 255, 255],
+        ],
+    )
+
+
+def test_dynamic_uniform_buffer_requires_size(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    arena = ctx.buffer(size=1024, uniform=True)
+    with pytest.raises(ValueError):
+        ctx.pipeline(
+            vertex_shader="#version 330 core\nvoid main() {}",
+            fragment_shader="#version 330 core\nvoid main() {}",
+            resources=[{"type": "uniform_buffer", "binding": 0, "buffer": arena, "dynamic": True}],
+            framebuffer=[image],
+        )
+
+
+def test_dynamic_uniform_buffer_invalid_offset(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    arena = ctx.buffer(size=1024, uniform=True)
+    pipeline = make_pipeline(ctx, image, arena)
+    alignment = ctx.info["uniform_buffer_offset_alignment"]
+
+    with pytest.raises(ValueError):
+        pipeline.dynamic_offset = -alignment
+
+    if alignment > 1:
+        with pytest.raises(ValueError):
+            pipeline.dynamic_offset = alignment + 1
+
+    with pytest.raises(ValueError):
+        pipeline.dynamic_offset = (1024 // alignment) * alignment
+
+    with pytest.raises(TypeError):
+        del pipeline.dynamic_offset
+
+    pipeline.dynamic_offset = alignment
+    assert pipeline.dynamic_offset == alignment
+
+
+def test_dynamic_uniform_buffer_draw_queue(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    arena = ctx.buffer(size=0x10000, uniform=True, access="stream_persistent")
+    pipeline = make_pipeline(ctx, image, arena)
+    queue = ctx.draw_queue()
+
+    objects = [
+        ((-0.5, -0.5), (1.0, 0.0, 0.0, 1.0)),
+        ((0.5, 0.5), (1.0, 1.0, 1.0, 1.0)),
+    ]
+
+    ctx.new_frame()
+    image.clear()
+    for offset, color in objects:
+        view = arena.stream(struct.pack("4f4f", *offset, 0.0, 0.0, *color))
+        pipeline.dynamic_offset = view.offset
+        queue.add(pipeline)
+    queue.flush()
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 48], [16, 48]],
+        [
+            [255, 0, 0, 255],
+            [255, 255, 255, 255],
+        ],
+    )
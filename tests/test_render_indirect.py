@@ -0,0 +1,62 @@
+import numpy as np
+import pytest
+import zengl
+
+import utils
+
+
+@pytest.mark.parametrize("indexed", [False, True])
+@pytest.mark.parametrize("indirect_count", [1, 2])
+def test_render_indirect(ctx: zengl.Context, indexed, indirect_count):
+    image = ctx.image((64, 64), "rgba8unorm")
+    if indexed:
+        commands = np.array([[0, 0, 0, 0, 0], [6, 1, 0, 0, 0], [6, 1, 18, 0, 0]], "u4")
+    else:
+        commands = np.array([[0, 0, 0, 0], [6, 1, 0, 0], [6, 1, 18, 0]], "u4")
+    indirect_buffer = ctx.buffer(commands, indirect=True)
+    view = indirect_buffer.view(offset=commands.itemsize * commands.shape[1])
+    pipeline = utils.make_quad_pipeline(ctx, image, indexed, indirect_buffer=view, indirect_count=indirect_count)
+
+    ctx.new_frame()
+    image.clear()
+    pipeline.render()
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 16, 48, 48], [16, 48, 16, 48]],
+        [
+            [255, 255, 255, 255],
+            [0, 0, 0, 0],
+            [0, 0, 0, 0],
+            [255, 255, 255, 255] if indirect_count == 2 else [0, 0, 0, 0],
+        ],
+    )
+
+
+def test_render_indirect_invalid(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    indirect_buffer = ctx.buffer(size=16, indirect=True)
+
+    with pytest.raises(TypeError):
+        utils.make_quad_pipeline(ctx, image, False, indirect_buffer=b"", indirect_count=1)
+
+    with pytest.raises(ValueError):
+        utils.make_quad_pipeline(ctx, image, False, indirect_buffer=indirect_buffer, indirect_count=2)
+
+    pipeline = utils.make_quad_pipeline(ctx, image, False, indirect_buffer=indirect_buffer, indirect_count=1)
+
+    with pytest.raises(ValueError):
+        pipeline.render_multi(bytes(12))
+
+    with pytest.raises(ValueError):
+        pipeline.indirect_count = 2
+
+    with pytest.raises(ValueError):
+        pipeline.indirect_count = -1
+
+    pipeline.indirect_count = 0
+    assert pipeline.indirect_count == 0
+
+    with pytest.raises(ValueError):
+        utils.make_quad_pipeline(ctx, image, False, indirect_buffer=ctx.buffer(size=32, indirect=True).view(size=16, offset=2), indirect_count=1)
@@ -0,0 +1,61 @@
+import numpy as np
+import pytest
+import zengl
+
+import utils
+
+
+@pytest.mark.parametrize("indexed", [False, True])
+@pytest.mark.parametrize("instance_count", [1, 2])
+def test_render_multi(ctx: zengl.Context, indexed, instance_count):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = utils.make_quad_pipeline(ctx, image, indexed)
+    render_data = np.array([[6, instance_count, 0, 0, 0], [6, instance_count, 18, 0, 0]], "i4")
+
+    ctx.new_frame()
+    image.clear()
+    pipeline.render_multi(render_data)
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 16, 48, 48], [16, 48, 16, 48]],
+        [
+            [255, 255, 255, 255],
+            [0, 0, 0, 0],
+            [0, 0, 0, 0],
+            [255, 255, 255, 255],
+        ],
+    )
+
+
+def test_render_multi_base_vertex(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = utils.make_quad_pipeline(ctx, image, True)
+    render_data = np.array([[6, 1, 0, 6, 0], [6, 1, 0, 12, 0]], "i4")
+
+    ctx.new_frame()
+    image.clear()
+    pipeline.render_multi(render_data)
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 16, 48, 48], [16, 48, 16, 48]],
+        [
+            [0, 0, 0, 0],
+            [255, 255, 255, 255],
+            [255, 255, 255, 255],
+            [0, 0, 0, 0],
+        ],
+    )
+
+
+def test_render_multi_invalid(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = utils.make_quad_pipeline(ctx, image, False)
+
+    with pytest.raises(ValueError):
+        pipeline.render_multi(bytes(12))
+
+    pipeline.render_multi(b"")
@@ -0,0 +1,87 @@
+import numpy as np
+import zengl
+
+
+def make_pipeline(ctx, image, viewport, color):
+    return ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            uniform vec3 color;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(color, 1.0);
+            }
+        """,
+        uniforms={
+            "color": color,
+        },
+        framebuffer=[image],
+        viewport=viewport,
+        topology="triangles",
+        vertex_count=3,
+    )
+
+
+def test_uniform_shadowing(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipelines = [
+        make_pipeline(ctx, image, (0, 0, 32, 32), (1.0, 0.0, 0.0)),
+        make_pipeline(ctx, image, (32, 0, 32, 32), (1.0, 0.0, 0.0)),
+        make_pipeline(ctx, image, (0, 32, 32, 32), (0.0, 1.0, 0.0)),
+        make_pipeline(ctx, image, (32, 32, 32, 32), (1.0, 0.0, 0.0)),
+    ]
+
+    ctx.new_frame()
+    image.clear()
+    ctx.render(pipelines)
+    assert ctx.skipped_uniform_calls == 1
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(
+        pixels[[16, 16, 48, 48], [16, 48, 16, 48]],
+        [
+            [255, 0, 0, 255],
+            [255, 0, 0, 255],
+            [0, 255, 0, 255],
+            [255, 0, 0, 255],
+        ],
+    )
+
+    ctx.new_frame()
+    assert ctx.skipped_uniform_calls == 0
+    pipelines[0].render()
+    assert ctx.skipped_uniform_calls == 1
+    ctx.end_frame()
+
+
+def test_uniform_shadowing_update(ctx: zengl.Context):
+    image = ctx.image((64, 64), "rgba8unorm")
+    pipeline = make_pipeline(ctx, image, (0, 0, 64, 64), (1.0, 0.0, 0.0))
+
+    ctx.new_frame()
+    image.clear()
+    pipeline.render()
+    pipeline.uniforms["color"][:] = np.array([0.0, 0.0, 1.0], "f4").tobytes()
+    pipeline.render()
+    assert ctx.skipped_uniform_calls == 0
+    ctx.end_frame()
+
+    pixels = np.frombuffer(image.read(), "u1").reshape(64, 64, 4)
+    np.testing.assert_array_equal(pixels[32, 32], [0, 0, 255, 255])
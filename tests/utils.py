@@ -1,4 +1,6 @@
+import numpy as np
 from OpenGL import GL
+import zengl
 
 ERROR_CODES = {
     0x0500: "GL_INVALID_ENUM",
@@ -23,3 +25,72 @@ def assert_gl_error(hint=""):
 
     name = ERROR_CODES.get(error, "")
     assert False, f"{hint}\nglGetError() = {error} | {name}"
+
+
+def make_color_pipeline(ctx, image, viewport, color):
+    return ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            vec2 positions[3] = vec2[](
+                vec2(-1.0, -1.0),
+                vec2(3.0, -1.0),
+                vec2(-1.0, 3.0)
+            );
+
+            void main() {
+                gl_Position = vec4(positions[gl_VertexID], 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            uniform vec3 color;
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(color, 1.0);
+            }
+        """,
+        uniforms={
+            "color": color,
+        },
+        framebuffer=[image],
+        viewport=viewport,
+        topology="triangles",
+        vertex_count=3,
+    )
+
+
+def make_quad_pipeline(ctx, image, indexed, **kwargs):
+    quads = []
+    for x, y in [(-1.0, -1.0), (0.0, -1.0), (-1.0, 0.0), (0.0, 0.0)]:
+        quads.extend([(x, y), (x + 1.0, y), (x, y + 1.0), (x, y + 1.0), (x + 1.0, y), (x + 1.0, y + 1.0)])
+    vertex_buffer = ctx.buffer(np.array(quads, "f4"))
+    index_buffer = ctx.buffer(np.arange(24, dtype="i4"), index=True) if indexed else None
+    return ctx.pipeline(
+        vertex_shader="""
+            #version 330 core
+
+            layout (location = 0) in vec2 in_vertex;
+
+            void main() {
+                gl_Position = vec4(in_vertex, 0.0, 1.0);
+            }
+        """,
+        fragment_shader="""
+            #version 330 core
+
+            layout (location = 0) out vec4 out_color;
+
+            void main() {
+                out_color = vec4(1.0, 1.0, 1.0, 1.0);
+            }
+        """,
+        framebuffer=[image],
+        topology="triangles",
+        vertex_buffers=zengl.bind(vertex_buffer, "2f", 0),
+        index_buffer=index_buffer,
+        **kwargs,
+    )
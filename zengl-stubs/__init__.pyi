@@ -138,10 +138,51 @@ ImageFormat = Literal[
     "r32float",
     "rg32float",
     "rgba32float",
+    "rgb10a2unorm",
+    "rg11b10ufloat",
+    "rgb9e5ufloat",
+    "rgba8unorm-srgb",
+    "rgba4unorm",
+    "rgb565unorm",
+    "r16unorm",
+    "rg16unorm",
+    "rgba16unorm",
     "depth16unorm",
     "depth24plus",
     "depth24plus-stencil8",
     "depth32float",
+    "bc1-rgba-unorm",
+    "bc2-rgba-unorm",
+    "bc3-rgba-unorm",
+    "bc4-r-unorm",
+    "bc4-r-snorm",
+    "bc5-rg-unorm",
+    "bc5-rg-snorm",
+    "bc6h-rgb-ufloat",
+    "bc6h-rgb-float",
+    "bc7-rgba-unorm",
+    "bc7-rgba-unorm-srgb",
+    "etc2-rgb8unorm",
+    "etc2-rgb8unorm-srgb",
+    "etc2-rgb8a1unorm",
+    "etc2-rgba8unorm",
+    "etc2-rgba8unorm-srgb",
+    "eac-r11unorm",
+    "eac-r11snorm",
+    "eac-rg11unorm",
+    "eac-rg11snorm",
+    "astc-4x4-unorm",
+    "astc-4x4-unorm-srgb",
+    "astc-5x5-unorm",
+    "astc-5x5-unorm-srgb",
+    "astc-6x6-unorm",
+    "astc-6x6-unorm-srgb",
+    "astc-8x8-unorm",
+    "astc-8x8-unorm-srgb",
+    "astc-10x10-unorm",
+    "astc-10x10-unorm-srgb",
+    "astc-12x12-unorm",
+    "astc-12x12-unorm-srgb",
 ]
 
 BufferAccess = Literal[
@@ -154,10 +195,13 @@ BufferAccess = Literal[
     "dynamic_draw",
     "dynamic_read",
     "dynamic_copy",
+    "stream_persistent",
 ]
 
 class BufferView:
-    pass
+    buffer: Buffer
+    offset: int
+    size: int
 
 Vec3 = Tuple[float, float, float]
 Viewport = Tuple[int, int, int, int]
@@ -173,6 +217,7 @@ class BufferResource(TypedDict, total=False):
     buffer: Buffer
     offset: int
     size: int
+    dynamic: bool
 
 class SamplerResource(TypedDict, total=False):
     type: Literal["sampler"]
@@ -191,7 +236,7 @@ class SamplerResource(TypedDict, total=False):
     max_anisotropy: float
 
 class VertexBufferBinding(TypedDict, total=False):
-    buffer: Buffer
+    buffer: Buffer | BufferView
     format: VertexFormat
     location: int
     offset: int
@@ -230,11 +275,19 @@ class Info(TypedDict):
     glsl: str
     max_uniform_buffer_bindings: int
     max_uniform_block_size: int
+    uniform_buffer_offset_alignment: int
     max_combined_uniform_blocks: int
     max_combined_texture_image_units: int
     max_vertex_attribs: int
     max_draw_buffers: int
     max_samples: int
+    compressed_formats: Tuple[str, ...]
+    extension_formats: Tuple[str, ...]
+
+class Readback:
+    size: int
+    def ready(self) -> bool: ...
+    def result(self, into=None) -> bytes | None: ...
 
 class ImageFace:
     image: Image
@@ -242,6 +295,8 @@ class ImageFace:
     samples: int
     color: bool
     def clear(self) -> None: ...
+    def read(self, size: Tuple[int, int] | None = None, offset: Tuple[int, int] | None = None, into=None) -> bytes: ...
+    def read_async(self, size: Tuple[int, int] | None = None, offset: Tuple[int, int] | None = None) -> Readback: ...
     def blit(
         self,
         target: ImageFace,
@@ -253,11 +308,36 @@ class ImageFace:
 class ContextLoader(Protocol):
     def load_opengl_function(name: str) -> int: ...
 
+class NullLoader:
+    interface: Tuple[List[Dict[str, Any]], List[Dict[str, Any]], List[Dict[str, Any]]]
+    def load_opengl_function(self, name: str) -> int: ...
+    def calls(self) -> Dict[str, int]: ...
+    def reset(self) -> None: ...
+
 class Buffer:
     size: int
+    persistent: bool
     def read(self, size: int | None = None, offset: int = 0, into=None) -> bytes: ...
     def write(self, data: Data, offset: int = 0) -> None: ...
     def view(self, size: int | None = None, offset: int = 0) -> BufferView: ...
+    def map(self) -> memoryview: ...
+    def stream(self, data: Data | None = None, size: int | None = None, align: int | None = None) -> BufferView: ...
+
+class BufferArenaStats(TypedDict):
+    size: int
+    used: int
+    free: int
+    largest_free: int
+    allocations: int
+    fragments: int
+
+class BufferArena:
+    buffer: Buffer
+    def allocate(self, data: Data | None = None, size: int | None = None, align: int = 4) -> BufferView: ...
+    def free(self, view: BufferView) -> None: ...
+    def defragment(self) -> List[BufferView]: ...
+    def stats(self) -> BufferArenaStats: ...
+    def __len__(self) -> int: ...
 
 class Image:
     size: Tuple[int, int]
@@ -274,9 +354,18 @@ class Image:
         offset: Tuple[int, int] | None = None,
         layer: int | None = None,
         level: int = 0,
+        levels: int | Literal["all"] | None = None,
     ) -> None: ...
     def mipmaps(self) -> None: ...
-    def read(self, size: Tuple[int, int] | None = None, offset: Tuple[int, int] | None = None, into=None) -> bytes: ...
+    def resolve(self) -> Image: ...
+    def read(
+        self,
+        size: Tuple[int, int] | None = None,
+        offset: Tuple[int, int] | None = None,
+        into=None,
+        levels: int | Literal["all"] | None = None,
+    ) -> bytes: ...
+    def read_async(self, size: Tuple[int, int] | None = None, offset: Tuple[int, int] | None = None) -> Readback: ...
     def blit(
         self,
         target: Image | None = None,
@@ -289,16 +378,32 @@ class Pipeline:
     vertex_count: int
     instance_count: int
     first_vertex: int
+    base_vertex: int
+    base_instance: int
+    indirect_count: int
+    dynamic_offset: int
     viewport: Viewport
     uniforms: Dict[str, memoryview] | None
+    label: str | None
     def render(self) -> None: ...
+    def render_multi(self, render_data: Data) -> None: ...
+
+class DrawQueue:
+    saved_binds: int
+    def add(self, pipeline: Pipeline, depth: float = 0.0) -> None: ...
+    def flush(self) -> None: ...
+    def clear(self) -> None: ...
+    def __len__(self) -> int: ...
 
 class Context:
     info: Info
     includes: Dict[str, str]
     before_frame: Callable | None
     after_frame: Callable | None
+    program_binary_cache: str | None
     frame_time: int
+    frame_time_latency: int
+    skipped_uniform_calls: int
     screen: int
     def buffer(
         self,
@@ -307,6 +412,7 @@ class Context:
         access: BufferAccess | None = None,
         index: bool = False,
         uniform: bool = False,
+        indirect: bool = False,
         external: int = 0,
     ) -> Buffer: ...
     def image(
@@ -333,23 +439,31 @@ class Context:
         blend: BlendSettings | None = None,
         framebuffer: Iterable[Image | ImageFace] | None = ...,
         vertex_buffers: Iterable[VertexBufferBinding] = (),
-        index_buffer: Buffer | None = None,
+        index_buffer: Buffer | BufferView | None = None,
         short_index: bool = False,
         cull_face: CullFace = "none",
         topology: Topology = "triangles",
         vertex_count: int = 0,
         instance_count: int = 0,
         first_vertex: int = 0,
+        base_vertex: int = 0,
+        base_instance: int = 0,
         viewport: Viewport | None = None,
         uniform_data: memoryview | None = None,
         viewport_data: memoryview | None = None,
         render_data: memoryview | None = None,
         includes: Dict[str, str] | None = None,
+        indirect_buffer: Buffer | BufferView | None = None,
+        indirect_count: int = 1,
         template: Pipeline = ...,
     ) -> Pipeline: ...
-    def new_frame(self, reset: bool = True, clear: bool = True, frame_time: bool = False) -> None: ...
+    def new_frame(self, reset: bool = True, clear: bool = True, frame_time: bool = False, profile: bool = False) -> None: ...
     def end_frame(self, clean: bool = True, flush: bool = True, sync: bool = False) -> None: ...
     def release(self, obj: Buffer | Image | Pipeline | Literal["shader_cache"] | Literal["all"]) -> None: ...
+    def render(self, pipelines: Iterable[Pipeline]) -> None: ...
+    def draw_queue(self, sort: bool = True) -> DrawQueue: ...
+    def buffer_arena(self, size: int, index: bool = False, access: BufferAccess | None = None) -> BufferArena: ...
+    def profile(self) -> List[Dict[str, Any]]: ...
 
 def init(loader: ContextLoader | None = None): ...
 def context() -> Context: ...
@@ -365,6 +479,7 @@ def camera(
     size: float = 1.0,
     clip: bool = False,
 ) -> bytes: ...
-def bind(buffer: Buffer | None, layout: str, *attributes: int) -> List[VertexBufferBinding]: ...
+def bind(buffer: Buffer | BufferView | None, layout: str, *attributes: int) -> List[VertexBufferBinding]: ...
 def calcsize(layout: str) -> int: ...
 def loader(headless: bool = False) -> ContextLoader: ...
+def null_loader(interface: Tuple[List[Dict[str, Any]], List[Dict[str, Any]], List[Dict[str, Any]]] | None = None) -> NullLoader: ...
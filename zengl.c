@@ -1,9 +1,18 @@
 #include <Python.h>
 #include <structmember.h>
+#if defined(__EMSCRIPTEN__) && !defined(EXTERN_GL)
 #define EXTERN_GL 1
+#endif
 #define MAX_ATTACHMENTS 8
 #define MAX_BUFFER_BINDINGS 8
 #define MAX_SAMPLER_BINDINGS 16
+#define MAX_READBACK_BUFFERS 8
+#define FRAME_TIME_QUERIES 4
+#define MAX_STREAM_FENCES 4
+#define LARGE_UPLOAD_SIZE 0x10000
+#define MAX_TRANSFER_SIZE 0x40000000
+
+typedef Py_ssize_t intptr;
 
 typedef struct VertexFormat {
     int type;
@@ -22,6 +31,9 @@ typedef struct ImageFormat {
     int color;
     int clear_type;
     int flags;
+    int compressed;
+    int block_width;
+    int block_height;
 } ImageFormat;
 
 typedef struct UniformBinding {
@@ -29,10 +41,13 @@ typedef struct UniformBinding {
     int location;
     int count;
     int offset;
+    int shadow;
+    int size;
 } UniformBinding;
 
 typedef struct UniformHeader {
     int count;
+    int shadow_size;
     UniformBinding binding[1];
 } UniformHeader;
 
@@ -64,8 +79,15 @@ typedef struct IntPair {
     int y;
 } IntPair;
 
+typedef struct UniformBufferSlot {
+    int buffer;
+    intptr offset;
+    intptr size;
+} UniformBufferSlot;
+
 typedef struct Limits {
     int max_uniform_buffer_bindings;
+    int uniform_buffer_offset_alignment;
     int max_uniform_block_size;
     int max_combined_uniform_blocks;
     int max_combined_texture_image_units;
@@ -91,8 +113,40 @@ typedef struct ModuleState {
     PyTypeObject * DescriptorSet_type;
     PyTypeObject * GlobalSettings_type;
     PyTypeObject * GLObject_type;
+    PyTypeObject * DrawQueue_type;
+    PyTypeObject * Readback_type;
+    PyTypeObject * BufferArena_type;
+    PyTypeObject * BufferMapping_type;
 } ModuleState;
 
+typedef struct FrameTimeQuery {
+    int query;
+    int frame;
+} FrameTimeQuery;
+
+typedef struct StreamFence {
+    void * fence;
+    intptr size;
+} StreamFence;
+
+typedef struct ProfileEvent {
+    PyObject * label;
+    const char * name;
+    int begin_query;
+    int end_query;
+    int frame;
+} ProfileEvent;
+
+typedef struct ReadbackBuffer {
+    int buffer;
+    intptr size;
+} ReadbackBuffer;
+
+typedef struct PendingReadback {
+    void * fence;
+    ReadbackBuffer buffer;
+} PendingReadback;
+
 typedef struct GCHeader {
     PyObject_HEAD
     struct GCHeader * gc_prev;
@@ -104,12 +158,15 @@ typedef struct GLObject {
     int uses;
     int obj;
     PyObject * extra;
+    PyObject * key;
+    char * shadow;
 } GLObject;
 
 typedef struct BufferBinding {
     struct Buffer * buffer;
-    int offset;
-    int size;
+    intptr offset;
+    intptr size;
+    int dynamic;
 } BufferBinding;
 
 typedef struct SamplerBinding {
@@ -119,6 +176,7 @@ typedef struct SamplerBinding {
 
 typedef struct DescriptorSetBuffers {
     int binding_count;
+    int dynamic;
     BufferBinding binding[MAX_BUFFER_BINDINGS];
 } DescriptorSetBuffers;
 
@@ -130,6 +188,7 @@ typedef struct DescriptorSetSamplers {
 typedef struct DescriptorSet {
     PyObject_HEAD
     int uses;
+    PyObject * key;
     DescriptorSetBuffers uniform_buffers;
     DescriptorSetSamplers samplers;
 } DescriptorSet;
@@ -146,6 +205,7 @@ typedef struct BlendState {
 typedef struct GlobalSettings {
     PyObject_HEAD
     int uses;
+    PyObject * key;
     int attachments;
     int cull_face;
     int depth_enabled;
@@ -175,6 +235,9 @@ typedef struct Context {
     PyObject * before_frame_callback;
     PyObject * after_frame_callback;
     PyObject * info_dict;
+    PyObject * compressed_formats;
+    PyObject * extension_formats;
+    PyObject * program_binary_cache;
     DescriptorSet * current_descriptor_set;
     GlobalSettings * current_global_settings;
     int is_mask_default;
@@ -183,16 +246,54 @@ typedef struct Context {
     Viewport current_viewport;
     int current_read_framebuffer;
     int current_draw_framebuffer;
+    int current_framebuffer_srgb;
     int current_program;
     int current_vertex_array;
+    int global_state_known;
+    int current_cull_face_enabled;
+    int current_cull_face;
+    int current_depth_enabled;
+    int current_depth_func;
     int current_depth_mask;
-    int current_stencil_mask;
-    int frame_time_query;
+    int current_stencil_enabled;
+    StencilSettings current_stencil_front;
+    StencilSettings current_stencil_back;
+    int current_blend_enabled;
+    BlendState current_blend;
+    int current_textures[MAX_SAMPLER_BINDINGS];
+    int current_samplers[MAX_SAMPLER_BINDINGS];
+    UniformBufferSlot current_uniform_buffers[MAX_BUFFER_BINDINGS];
+    ReadbackBuffer readback_buffers[MAX_READBACK_BUFFERS];
+    int readback_buffer_count;
+    PendingReadback * pending_readbacks;
+    int pending_readback_count;
+    int pending_readback_capacity;
+    FrameTimeQuery frame_time_queries[FRAME_TIME_QUERIES];
+    int frame_time_head;
+    int frame_time_pending;
     int frame_time_query_running;
     int frame_time;
+    int frame_time_latency;
+    int frame_index;
+    ProfileEvent * profile_events;
+    int * profile_queries;
+    int profile_event_count;
+    int profile_event_capacity;
+    int profile_query_count;
+    int profile_running;
+    PyObject * profile_results;
+    int flushing;
+    int skipped_uniform_calls;
     int default_texture_unit;
     int is_gles;
     int is_webgl;
+    int program_binary_support;
+    int indirect_draw_support;
+    int multi_draw_indirect_support;
+    int base_vertex_support;
+    int base_instance_support;
+    int timestamp_query_support;
+    int persistent_mapping_support;
     Limits limits;
 } Context;
 
@@ -203,8 +304,18 @@ typedef struct Buffer {
     Context * ctx;
     int buffer;
     int target;
-    int size;
+    intptr size;
     int access;
+    int stream;
+    int persistent;
+    char * mapped;
+    int mapped_exports;
+    StreamFence stream_fences[MAX_STREAM_FENCES];
+    int stream_fence_count;
+    intptr stream_head;
+    intptr stream_used;
+    int stream_frame;
+    intptr stream_frame_used;
 } Buffer;
 
 typedef struct Image {
@@ -216,6 +327,7 @@ typedef struct Image {
     PyObject * format;
     PyObject * faces;
     PyObject * layers;
+    struct Image * resolve_target;
     ImageFormat fmt;
     ClearValue clear_value;
     int image;
@@ -234,6 +346,8 @@ typedef struct RenderParameters {
     int vertex_count;
     int instance_count;
     int first_vertex;
+    int base_vertex;
+    int base_instance;
 } RenderParameters;
 
 typedef struct Pipeline {
@@ -252,17 +366,58 @@ typedef struct Pipeline {
     PyObject * uniform_data;
     PyObject * viewport_data;
     PyObject * render_data;
+    PyObject * label;
     Py_buffer uniform_layout_buffer;
     Py_buffer uniform_data_buffer;
     Py_buffer viewport_data_buffer;
     Py_buffer render_data_buffer;
     RenderParameters params;
     Viewport viewport;
+    Buffer * indirect_buffer;
+    intptr indirect_offset;
+    intptr indirect_size;
+    int indirect_count;
+    intptr dynamic_offset;
+    int base_draws;
     int topology;
     int index_type;
     int index_size;
+    intptr index_offset;
+    int srgb;
 } Pipeline;
 
+typedef struct DrawCommand {
+    Pipeline * pipeline;
+    double depth;
+    intptr dynamic_offset;
+    intptr uniform_offset;
+    Viewport viewport;
+    RenderParameters params;
+    int indirect_count;
+} DrawCommand;
+
+typedef struct DrawQueue {
+    PyObject_HEAD
+    Context * ctx;
+    DrawCommand * commands;
+    int count;
+    int capacity;
+    char * uniform_data;
+    intptr uniform_size;
+    intptr uniform_capacity;
+    int sort;
+    int saved_binds;
+    int flushing;
+} DrawQueue;
+
+typedef struct Readback {
+    PyObject_HEAD
+    Context * ctx;
+    ReadbackBuffer buffer;
+    void * fence;
+    intptr size;
+} Readback;
+
 typedef struct ImageFace {
     PyObject_HEAD
     Context * ctx;
@@ -277,14 +432,32 @@ typedef struct ImageFace {
     int flags;
 } ImageFace;
 
+typedef struct BufferMapping {
+    PyObject_HEAD
+    Buffer * buffer;
+} BufferMapping;
+
 typedef struct BufferView {
     PyObject_HEAD
     Buffer * buffer;
-    int offset;
-    int size;
+    intptr offset;
+    intptr size;
 } BufferView;
 
-typedef Py_ssize_t intptr;
+typedef struct ArenaBlock {
+    BufferView * view;
+    int align;
+} ArenaBlock;
+
+typedef struct BufferArena {
+    PyObject_HEAD
+    Context * ctx;
+    Buffer * buffer;
+    ArenaBlock * blocks;
+    int count;
+    int capacity;
+    intptr used;
+} BufferArena;
 
 #ifdef _WIN32
 #define GL __stdcall
@@ -305,6 +478,10 @@ typedef Py_ssize_t intptr;
 #define GL_DEPTH_TEST 0x0B71
 #define GL_STENCIL_TEST 0x0B90
 #define GL_BLEND 0x0BE2
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#define GL_UNPACK_ALIGNMENT 0x0CF5
+#define GL_PACK_ROW_LENGTH 0x0D02
+#define GL_PACK_ALIGNMENT 0x0D05
 #define GL_TEXTURE_2D 0x0DE1
 #define GL_UNSIGNED_SHORT 0x1403
 #define GL_UNSIGNED_INT 0x1405
@@ -313,12 +490,15 @@ typedef Py_ssize_t intptr;
 #define GL_VENDOR 0x1F00
 #define GL_RENDERER 0x1F01
 #define GL_VERSION 0x1F02
+#define GL_EXTENSIONS 0x1F03
+#define GL_NUM_EXTENSIONS 0x821D
 #define GL_NEAREST 0x2600
 #define GL_LINEAR 0x2601
 #define GL_TEXTURE_MAG_FILTER 0x2800
 #define GL_TEXTURE_MIN_FILTER 0x2801
 #define GL_TEXTURE_WRAP_S 0x2802
 #define GL_TEXTURE_WRAP_T 0x2803
+#define GL_UNPACK_IMAGE_HEIGHT 0x806E
 #define GL_TEXTURE_WRAP_R 0x8072
 #define GL_TEXTURE_MIN_LOD 0x813A
 #define GL_TEXTURE_MAX_LOD 0x813B
@@ -329,6 +509,7 @@ typedef Py_ssize_t intptr;
 #define GL_TEXTURE_COMPARE_MODE 0x884C
 #define GL_TEXTURE_COMPARE_FUNC 0x884D
 #define GL_QUERY_RESULT 0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
 #define GL_ARRAY_BUFFER 0x8892
 #define GL_ELEMENT_ARRAY_BUFFER 0x8893
 #define GL_STATIC_DRAW 0x88E4
@@ -361,15 +542,31 @@ typedef Py_ssize_t intptr;
 #define GL_MAX_COMBINED_UNIFORM_BLOCKS 0x8A2E
 #define GL_MAX_UNIFORM_BUFFER_BINDINGS 0x8A2F
 #define GL_MAX_UNIFORM_BLOCK_SIZE 0x8A30
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
 #define GL_ACTIVE_UNIFORM_BLOCKS 0x8A36
 #define GL_UNIFORM_BLOCK_DATA_SIZE 0x8A40
 #define GL_PROGRAM_POINT_SIZE 0x8642
 #define GL_TEXTURE_CUBE_MAP_SEAMLESS 0x884F
+#define GL_FRAMEBUFFER_SRGB 0x8DB9
+#define GL_SRGB8_ALPHA8 0x8C43
 #define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
 #define GL_SYNC_FLUSH_COMMANDS_BIT 0x0001
 #define GL_TIME_ELAPSED 0x88BF
 #define GL_PRIMITIVE_RESTART_FIXED_INDEX 0x8D69
 #define GL_TEXTURE_MAX_ANISOTROPY 0x84FE
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_STREAM_READ 0x88E1
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#define GL_TIMESTAMP 0x8E28
+#define GL_STREAM_DRAW 0x88E0
+#define GL_MAP_WRITE_BIT 0x0002
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
 
 RESOLVE(void, glCullFace, int);
 RESOLVE(void, glClear, int);
@@ -392,9 +589,16 @@ RESOLVE(void, glDeleteTextures, int, const int *);
 RESOLVE(void, glGenTextures, int, int *);
 RESOLVE(void, glTexImage3D, int, int, int, int, int, int, int, int, int, const void *);
 RESOLVE(void, glTexSubImage3D, int, int, int, int, int, int, int, int, int, int, const void *);
+RESOLVE(void, glCompressedTexImage2D, int, int, int, int, int, int, int, const void *);
+RESOLVE(void, glCompressedTexImage3D, int, int, int, int, int, int, int, int, const void *);
+RESOLVE(void, glCompressedTexSubImage2D, int, int, int, int, int, int, int, int, const void *);
+RESOLVE(void, glCompressedTexSubImage3D, int, int, int, int, int, int, int, int, int, int, const void *);
+RESOLVE(const char *, glGetStringi, int, int);
+RESOLVE(void, glPixelStorei, int, int);
 RESOLVE(void, glActiveTexture, int);
 RESOLVE(void, glBlendFuncSeparate, int, int, int, int);
 RESOLVE(void, glGenQueries, int, int *);
+RESOLVE(void, glDeleteQueries, int, const int *);
 RESOLVE(void, glBeginQuery, int, int);
 RESOLVE(void, glEndQuery, int);
 RESOLVE(void, glGetQueryObjectuiv, int, int, void *);
@@ -487,6 +691,32 @@ RESOLVE(void, glBindSampler, int, int);
 RESOLVE(void, glSamplerParameteri, int, int, int);
 RESOLVE(void, glSamplerParameterf, int, int, float);
 RESOLVE(void, glVertexAttribDivisor, int, int);
+RESOLVE(void, glGetProgramBinary, int, int, int *, int *, void *);
+RESOLVE(void, glProgramBinary, int, int, const void *, int);
+RESOLVE(void, glProgramParameteri, int, int, int);
+RESOLVE(void, glMultiDrawArrays, int, const int *, const int *, int);
+RESOLVE(void, glMultiDrawElements, int, const int *, int, const intptr *, int);
+RESOLVE(void, glDrawElementsInstancedBaseVertex, int, int, int, intptr, int, int);
+RESOLVE(void, glDrawArraysInstancedBaseInstance, int, int, int, int, int);
+RESOLVE(void, glDrawElementsInstancedBaseVertexBaseInstance, int, int, int, intptr, int, int, int);
+RESOLVE(void, glDrawArraysIndirect, int, intptr);
+RESOLVE(void, glDrawElementsIndirect, int, int, intptr);
+RESOLVE(void, glMultiDrawArraysIndirect, int, intptr, int, int);
+RESOLVE(void, glMultiDrawElementsIndirect, int, int, intptr, int, int);
+RESOLVE(void, glQueryCounter, int, int);
+RESOLVE(void, glGetQueryObjectui64v, int, int, void *);
+RESOLVE(void, glBufferStorage, int, intptr, const void *, int);
+RESOLVE(void *, glMapBufferRange, int, intptr, intptr, int);
+RESOLVE(int, glUnmapBuffer, int);
+
+static int program_binary_functions;
+static int multi_draw_functions;
+static int indirect_draw_functions;
+static int base_vertex_functions;
+static int base_instance_functions;
+static int multi_draw_indirect_functions;
+static int timestamp_query_functions;
+static int buffer_storage_functions;
 
 #ifndef EXTERN_GL
 
@@ -510,6 +740,7 @@ static void load_gl(PyObject * loader) {
 
     #define check(name) if (!name) { if (PyErr_Occurred()) return; PyList_Append(missing, PyUnicode_FromString(#name)); }
     #define load(name) *(void **)&name = load_opengl_function(loader_function, #name); check(name)
+    #define load_optional(name) *(void **)&name = load_opengl_function(loader_function, #name); if (PyErr_Occurred()) return
 
     load(glCullFace);
     load(glClear);
@@ -532,9 +763,16 @@ static void load_gl(PyObject * loader) {
     load(glGenTextures);
     load(glTexImage3D);
     load(glTexSubImage3D);
+    load(glCompressedTexImage2D);
+    load(glCompressedTexImage3D);
+    load(glCompressedTexSubImage2D);
+    load(glCompressedTexSubImage3D);
+    load(glGetStringi);
+    load(glPixelStorei);
     load(glActiveTexture);
     load(glBlendFuncSeparate);
     load(glGenQueries);
+    load(glDeleteQueries);
     load(glBeginQuery);
     load(glEndQuery);
     load(glGetQueryObjectuiv);
@@ -627,7 +865,35 @@ static void load_gl(PyObject * loader) {
     load(glSamplerParameteri);
     load(glSamplerParameterf);
     load(glVertexAttribDivisor);
-
+    load_optional(glGetProgramBinary);
+    load_optional(glProgramBinary);
+    load_optional(glProgramParameteri);
+
+    load_optional(glMultiDrawArrays);
+    load_optional(glMultiDrawElements);
+    load_optional(glDrawElementsInstancedBaseVertex);
+    load_optional(glDrawArraysInstancedBaseInstance);
+    load_optional(glDrawElementsInstancedBaseVertexBaseInstance);
+    load_optional(glDrawArraysIndirect);
+    load_optional(glDrawElementsIndirect);
+    load_optional(glMultiDrawArraysIndirect);
+    load_optional(glMultiDrawElementsIndirect);
+    load_optional(glQueryCounter);
+    load_optional(glGetQueryObjectui64v);
+    load_optional(glBufferStorage);
+    load_optional(glMapBufferRange);
+    load_optional(glUnmapBuffer);
+
+    program_binary_functions = glGetProgramBinary && glProgramBinary && glProgramParameteri;
+    multi_draw_functions = glMultiDrawArrays && glMultiDrawElements;
+    indirect_draw_functions = glDrawArraysIndirect && glDrawElementsIndirect;
+    base_vertex_functions = glDrawElementsInstancedBaseVertex != NULL;
+    base_instance_functions = glDrawArraysInstancedBaseInstance && glDrawElementsInstancedBaseVertexBaseInstance;
+    multi_draw_indirect_functions = glMultiDrawArraysIndirect && glMultiDrawElementsIndirect;
+    timestamp_query_functions = glQueryCounter && glGetQueryObjectui64v;
+    buffer_storage_functions = glBufferStorage && glMapBufferRange && glUnmapBuffer;
+
+    #undef load_optional
     #undef load
     #undef check
 
@@ -642,15 +908,582 @@ static void load_gl(PyObject * loader) {
 #else
 
 static void load_gl(PyObject * loader) {
+    program_binary_functions = 1;
+    multi_draw_functions = 1;
+    indirect_draw_functions = 0;
+    multi_draw_indirect_functions = 0;
+    base_vertex_functions = 0;
+    base_instance_functions = 0;
+    timestamp_query_functions = 0;
+    buffer_storage_functions = 0;
+}
+
+#endif
+
+#ifndef EXTERN_GL
+
+#define NULL_GL_FUNCTIONS(X) \
+    X(glCullFace) \
+    X(glClear) \
+    X(glTexParameteri) \
+    X(glTexImage2D) \
+    X(glDepthMask) \
+    X(glDisable) \
+    X(glEnable) \
+    X(glFlush) \
+    X(glDepthFunc) \
+    X(glReadBuffer) \
+    X(glReadPixels) \
+    X(glGetError) \
+    X(glGetIntegerv) \
+    X(glGetString) \
+    X(glViewport) \
+    X(glTexSubImage2D) \
+    X(glBindTexture) \
+    X(glDeleteTextures) \
+    X(glGenTextures) \
+    X(glTexImage3D) \
+    X(glTexSubImage3D) \
+    X(glCompressedTexImage2D) \
+    X(glCompressedTexImage3D) \
+    X(glCompressedTexSubImage2D) \
+    X(glCompressedTexSubImage3D) \
+    X(glGetStringi) \
+    X(glPixelStorei) \
+    X(glActiveTexture) \
+    X(glBlendFuncSeparate) \
+    X(glGenQueries) \
+    X(glDeleteQueries) \
+    X(glBeginQuery) \
+    X(glEndQuery) \
+    X(glGetQueryObjectuiv) \
+    X(glBindBuffer) \
+    X(glDeleteBuffers) \
+    X(glGenBuffers) \
+    X(glBufferData) \
+    X(glBufferSubData) \
+    X(glGetBufferSubData) \
+    X(glBlendEquationSeparate) \
+    X(glDrawBuffers) \
+    X(glStencilOpSeparate) \
+    X(glStencilFuncSeparate) \
+    X(glStencilMaskSeparate) \
+    X(glAttachShader) \
+    X(glCompileShader) \
+    X(glCreateProgram) \
+    X(glCreateShader) \
+    X(glDeleteProgram) \
+    X(glDeleteShader) \
+    X(glEnableVertexAttribArray) \
+    X(glGetActiveAttrib) \
+    X(glGetActiveUniform) \
+    X(glGetAttribLocation) \
+    X(glGetProgramiv) \
+    X(glGetProgramInfoLog) \
+    X(glGetShaderiv) \
+    X(glGetShaderInfoLog) \
+    X(glGetUniformLocation) \
+    X(glLinkProgram) \
+    X(glShaderSource) \
+    X(glUseProgram) \
+    X(glUniform1i) \
+    X(glUniform1fv) \
+    X(glUniform2fv) \
+    X(glUniform3fv) \
+    X(glUniform4fv) \
+    X(glUniform1iv) \
+    X(glUniform2iv) \
+    X(glUniform3iv) \
+    X(glUniform4iv) \
+    X(glUniformMatrix2fv) \
+    X(glUniformMatrix3fv) \
+    X(glUniformMatrix4fv) \
+    X(glVertexAttribPointer) \
+    X(glUniformMatrix2x3fv) \
+    X(glUniformMatrix3x2fv) \
+    X(glUniformMatrix2x4fv) \
+    X(glUniformMatrix4x2fv) \
+    X(glUniformMatrix3x4fv) \
+    X(glUniformMatrix4x3fv) \
+    X(glBindBufferRange) \
+    X(glVertexAttribIPointer) \
+    X(glUniform1uiv) \
+    X(glUniform2uiv) \
+    X(glUniform3uiv) \
+    X(glUniform4uiv) \
+    X(glClearBufferiv) \
+    X(glClearBufferuiv) \
+    X(glClearBufferfv) \
+    X(glClearBufferfi) \
+    X(glBindRenderbuffer) \
+    X(glDeleteRenderbuffers) \
+    X(glGenRenderbuffers) \
+    X(glBindFramebuffer) \
+    X(glDeleteFramebuffers) \
+    X(glGenFramebuffers) \
+    X(glFramebufferTexture2D) \
+    X(glFramebufferRenderbuffer) \
+    X(glGenerateMipmap) \
+    X(glBlitFramebuffer) \
+    X(glRenderbufferStorageMultisample) \
+    X(glFramebufferTextureLayer) \
+    X(glBindVertexArray) \
+    X(glDeleteVertexArrays) \
+    X(glGenVertexArrays) \
+    X(glDrawArraysInstanced) \
+    X(glDrawElementsInstanced) \
+    X(glCopyBufferSubData) \
+    X(glGetUniformBlockIndex) \
+    X(glGetActiveUniformBlockiv) \
+    X(glGetActiveUniformBlockName) \
+    X(glUniformBlockBinding) \
+    X(glFenceSync) \
+    X(glDeleteSync) \
+    X(glClientWaitSync) \
+    X(glGenSamplers) \
+    X(glDeleteSamplers) \
+    X(glBindSampler) \
+    X(glSamplerParameteri) \
+    X(glSamplerParameterf) \
+    X(glVertexAttribDivisor) \
+    X(glMultiDrawArrays) \
+    X(glMultiDrawElements) \
+    X(glDrawElementsInstancedBaseVertex) \
+    X(glDrawArraysInstancedBaseInstance) \
+    X(glDrawElementsInstancedBaseVertexBaseInstance) \
+    X(glDrawArraysIndirect) \
+    X(glDrawElementsIndirect) \
+    X(glMultiDrawArraysIndirect) \
+    X(glMultiDrawElementsIndirect) \
+    X(glQueryCounter) \
+    X(glGetQueryObjectui64v)
+
+#define NULL_GL_ENUM(name) NULL_##name,
+#define NULL_GL_NAME(name) #name,
+#define NULL_GL_FUNCTION(name) (void *)null_##name,
+
+enum NullGLFunction {
+    NULL_GL_FUNCTIONS(NULL_GL_ENUM)
+    NULL_GL_COUNT,
+};
+
+static long long null_gl_calls[NULL_GL_COUNT];
+static PyObject * null_gl_loader;
+static int null_gl_objects;
+
+static void null_gen(int n, int * ids) {
+    for (int i = 0; i < n; ++i) {
+        ids[i] = ++null_gl_objects;
+    }
+}
+
+static void null_string(const char * text, int bufsize, int * length, char * buffer) {
+    int size = 0;
+    while (text[size] && size < bufsize - 1) {
+        buffer[size] = text[size];
+        size += 1;
+    }
+    if (bufsize > 0) {
+        buffer[size] = 0;
+    }
+    if (length) {
+        *length = size;
+    }
+}
+
+static PyObject * null_group(int group) {
+    if (!null_gl_loader) {
+        return NULL;
+    }
+    PyObject * interface = PyObject_GetAttrString(null_gl_loader, "interface");
+    PyObject * res = interface ? PySequence_GetItem(interface, group) : NULL;
+    Py_XDECREF(interface);
+    PyErr_Clear();
+    return res;
+}
+
+static PyObject * null_item(int group, int index) {
+    PyObject * items = null_group(group);
+    PyObject * res = items ? PySequence_GetItem(items, index) : NULL;
+    Py_XDECREF(items);
+    PyErr_Clear();
+    return res;
+}
+
+static int null_count(int group) {
+    PyObject * items = null_group(group);
+    int res = items ? (int)PySequence_Size(items) : 0;
+    Py_XDECREF(items);
+    PyErr_Clear();
+    return res > 0 ? res : 0;
+}
+
+static int null_field(PyObject * item, const char * key) {
+    PyObject * value = item ? PyMapping_GetItemString(item, key) : NULL;
+    int res = value ? (int)PyLong_AsLong(value) : 0;
+    Py_XDECREF(value);
+    PyErr_Clear();
+    return res;
+}
+
+static void null_name(PyObject * item, int bufsize, int * length, char * name) {
+    PyObject * value = item ? PyMapping_GetItemString(item, "name") : NULL;
+    const char * text = value ? PyUnicode_AsUTF8AndSize(value, NULL) : NULL;
+    null_string(text ? text : "", bufsize, length, name);
+    Py_XDECREF(value);
+    PyErr_Clear();
+}
+
+static void null_active(int group, int index, int bufsize, int * length, int * size, int * type, char * name) {
+    PyObject * item = null_item(group, index);
+    *size = null_field(item, "size");
+    *type = null_field(item, "gltype");
+    null_name(item, bufsize, length, name);
+    Py_XDECREF(item);
+}
+
+static int null_find(int group, const char * name, const char * key) {
+    int count = null_count(group);
+    for (int i = 0; i < count; ++i) {
+        PyObject * item = null_item(group, i);
+        PyObject * value = item ? PyMapping_GetItemString(item, "name") : NULL;
+        int found = value && PyUnicode_Check(value) && !PyUnicode_CompareWithASCIIString(value, name);
+        int res = found && key ? null_field(item, key) : i;
+        Py_XDECREF(value);
+        Py_XDECREF(item);
+        PyErr_Clear();
+        if (found) {
+            return res;
+        }
+    }
+    return -1;
+}
+
+static void GL null_glCullFace(int a) { null_gl_calls[NULL_glCullFace] += 1; }
+static void GL null_glClear(int a) { null_gl_calls[NULL_glClear] += 1; }
+static void GL null_glTexParameteri(int a, int b, int c) { null_gl_calls[NULL_glTexParameteri] += 1; }
+static void GL null_glTexImage2D(int a, int b, int c, int d, int e, int f, int g, int h, const void * i) { null_gl_calls[NULL_glTexImage2D] += 1; }
+static void GL null_glDepthMask(int a) { null_gl_calls[NULL_glDepthMask] += 1; }
+static void GL null_glDisable(int a) { null_gl_calls[NULL_glDisable] += 1; }
+static void GL null_glEnable(int a) { null_gl_calls[NULL_glEnable] += 1; }
+static void GL null_glFlush(void) { null_gl_calls[NULL_glFlush] += 1; }
+static void GL null_glDepthFunc(int a) { null_gl_calls[NULL_glDepthFunc] += 1; }
+static void GL null_glReadBuffer(int a) { null_gl_calls[NULL_glReadBuffer] += 1; }
+static void GL null_glReadPixels(int a, int b, int c, int d, int e, int f, void * g) { null_gl_calls[NULL_glReadPixels] += 1; }
+
+static int GL null_glGetError(void) {
+    null_gl_calls[NULL_glGetError] += 1;
+    return 0;
+}
+
+static void GL null_glGetIntegerv(int pname, int * data) {
+    null_gl_calls[NULL_glGetIntegerv] += 1;
+    switch (pname) {
+        case GL_MAX_UNIFORM_BUFFER_BINDINGS: *data = 72; break;
+        case GL_MAX_UNIFORM_BLOCK_SIZE: *data = 65536; break;
+        case GL_MAX_COMBINED_UNIFORM_BLOCKS: *data = 72; break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: *data = 192; break;
+        case GL_MAX_TEXTURE_IMAGE_UNITS: *data = 32; break;
+        case GL_MAX_VERTEX_ATTRIBS: *data = 16; break;
+        case GL_MAX_DRAW_BUFFERS: *data = 8; break;
+        case GL_MAX_SAMPLES: *data = 8; break;
+        default: *data = 0; break;
+    }
+}
+
+static const char * GL null_glGetString(int name) {
+    null_gl_calls[NULL_glGetString] += 1;
+    switch (name) {
+        case GL_VENDOR: return "zengl";
+        case GL_RENDERER: return "null";
+        case GL_VERSION: return "4.6.0 null";
+        case GL_SHADING_LANGUAGE_VERSION: return "4.60";
+    }
+    return "";
+}
+
+static void GL null_glViewport(int a, int b, int c, int d) { null_gl_calls[NULL_glViewport] += 1; }
+static void GL null_glTexSubImage2D(int a, int b, int c, int d, int e, int f, int g, int h, const void * i) { null_gl_calls[NULL_glTexSubImage2D] += 1; }
+static void GL null_glBindTexture(int a, int b) { null_gl_calls[NULL_glBindTexture] += 1; }
+static void GL null_glDeleteTextures(int a, const int * b) { null_gl_calls[NULL_glDeleteTextures] += 1; }
+
+static void GL null_glGenTextures(int n, int * ids) {
+    null_gl_calls[NULL_glGenTextures] += 1;
+    null_gen(n, ids);
+}
+
+static void GL null_glTexImage3D(int a, int b, int c, int d, int e, int f, int g, int h, int i, const void * j) { null_gl_calls[NULL_glTexImage3D] += 1; }
+static void GL null_glTexSubImage3D(int a, int b, int c, int d, int e, int f, int g, int h, int i, int j, const void * k) { null_gl_calls[NULL_glTexSubImage3D] += 1; }
+static void GL null_glCompressedTexImage2D(int a, int b, int c, int d, int e, int f, int g, const void * h) { null_gl_calls[NULL_glCompressedTexImage2D] += 1; }
+static void GL null_glCompressedTexImage3D(int a, int b, int c, int d, int e, int f, int g, int h, const void * i) { null_gl_calls[NULL_glCompressedTexImage3D] += 1; }
+static void GL null_glCompressedTexSubImage2D(int a, int b, int c, int d, int e, int f, int g, int h, const void * i) { null_gl_calls[NULL_glCompressedTexSubImage2D] += 1; }
+static void GL null_glCompressedTexSubImage3D(int a, int b, int c, int d, int e, int f, int g, int h, int i, int j, const void * k) { null_gl_calls[NULL_glCompressedTexSubImage3D] += 1; }
+static const char * GL null_glGetStringi(int a, int b) { null_gl_calls[NULL_glGetStringi] += 1; return NULL; }
+static void GL null_glPixelStorei(int a, int b) { null_gl_calls[NULL_glPixelStorei] += 1; }
+static void GL null_glActiveTexture(int a) { null_gl_calls[NULL_glActiveTexture] += 1; }
+static void GL null_glBlendFuncSeparate(int a, int b, int c, int d) { null_gl_calls[NULL_glBlendFuncSeparate] += 1; }
+
+static void GL null_glGenQueries(int n, int * ids) {
+    null_gl_calls[NULL_glGenQueries] += 1;
+    null_gen(n, ids);
+}
+
+static void GL null_glDeleteQueries(int a, const int * b) { null_gl_calls[NULL_glDeleteQueries] += 1; }
+static void GL null_glBeginQuery(int a, int b) { null_gl_calls[NULL_glBeginQuery] += 1; }
+static void GL null_glEndQuery(int a) { null_gl_calls[NULL_glEndQuery] += 1; }
+
+static void GL null_glGetQueryObjectuiv(int id, int pname, void * params) {
+    null_gl_calls[NULL_glGetQueryObjectuiv] += 1;
+    *(unsigned *)params = pname == GL_QUERY_RESULT_AVAILABLE;
+}
+
+static void GL null_glBindBuffer(int a, int b) { null_gl_calls[NULL_glBindBuffer] += 1; }
+static void GL null_glDeleteBuffers(int a, const int * b) { null_gl_calls[NULL_glDeleteBuffers] += 1; }
+
+static void GL null_glGenBuffers(int n, int * ids) {
+    null_gl_calls[NULL_glGenBuffers] += 1;
+    null_gen(n, ids);
+}
+
+static void GL null_glBufferData(int a, intptr b, const void * c, int d) { null_gl_calls[NULL_glBufferData] += 1; }
+static void GL null_glBufferSubData(int a, intptr b, intptr c, const void * d) { null_gl_calls[NULL_glBufferSubData] += 1; }
+static void GL null_glGetBufferSubData(int a, intptr b, intptr c, void * d) { null_gl_calls[NULL_glGetBufferSubData] += 1; }
+static void GL null_glBlendEquationSeparate(int a, int b) { null_gl_calls[NULL_glBlendEquationSeparate] += 1; }
+static void GL null_glDrawBuffers(int a, const int * b) { null_gl_calls[NULL_glDrawBuffers] += 1; }
+static void GL null_glStencilOpSeparate(int a, int b, int c, int d) { null_gl_calls[NULL_glStencilOpSeparate] += 1; }
+static void GL null_glStencilFuncSeparate(int a, int b, int c, int d) { null_gl_calls[NULL_glStencilFuncSeparate] += 1; }
+static void GL null_glStencilMaskSeparate(int a, int b) { null_gl_calls[NULL_glStencilMaskSeparate] += 1; }
+static void GL null_glAttachShader(int a, int b) { null_gl_calls[NULL_glAttachShader] += 1; }
+static void GL null_glCompileShader(int a) { null_gl_calls[NULL_glCompileShader] += 1; }
+
+static int GL null_glCreateProgram(void) {
+    null_gl_calls[NULL_glCreateProgram] += 1;
+    return ++null_gl_objects;
+}
+
+static int GL null_glCreateShader(int type) {
+    null_gl_calls[NULL_glCreateShader] += 1;
+    return ++null_gl_objects;
+}
+
+static void GL null_glDeleteProgram(int a) { null_gl_calls[NULL_glDeleteProgram] += 1; }
+static void GL null_glDeleteShader(int a) { null_gl_calls[NULL_glDeleteShader] += 1; }
+static void GL null_glEnableVertexAttribArray(int a) { null_gl_calls[NULL_glEnableVertexAttribArray] += 1; }
+
+static void GL null_glGetActiveAttrib(int program, int index, int bufsize, int * length, int * size, int * type, char * name) {
+    null_gl_calls[NULL_glGetActiveAttrib] += 1;
+    null_active(0, index, bufsize, length, size, type, name);
+}
+
+static void GL null_glGetActiveUniform(int program, int index, int bufsize, int * length, int * size, int * type, char * name) {
+    null_gl_calls[NULL_glGetActiveUniform] += 1;
+    null_active(1, index, bufsize, length, size, type, name);
+}
+
+static int GL null_glGetAttribLocation(int program, const char * name) {
+    null_gl_calls[NULL_glGetAttribLocation] += 1;
+    return null_find(0, name, "location");
+}
+
+static void GL null_glGetProgramiv(int program, int pname, int * params) {
+    null_gl_calls[NULL_glGetProgramiv] += 1;
+    switch (pname) {
+        case GL_LINK_STATUS: *params = 1; break;
+        case GL_ACTIVE_ATTRIBUTES: *params = null_count(0); break;
+        case GL_ACTIVE_UNIFORMS: *params = null_count(1); break;
+        case GL_ACTIVE_UNIFORM_BLOCKS: *params = null_count(2); break;
+        default: *params = 0; break;
+    }
+}
+
+static void GL null_glGetProgramInfoLog(int program, int bufsize, int * length, char * log) {
+    null_gl_calls[NULL_glGetProgramInfoLog] += 1;
+    null_string("", bufsize, length, log);
+}
+
+static void GL null_glGetShaderiv(int shader, int pname, int * params) {
+    null_gl_calls[NULL_glGetShaderiv] += 1;
+    *params = pname == GL_COMPILE_STATUS;
+}
+
+static void GL null_glGetShaderInfoLog(int shader, int bufsize, int * length, char * log) {
+    null_gl_calls[NULL_glGetShaderInfoLog] += 1;
+    null_string("", bufsize, length, log);
+}
+
+static int GL null_glGetUniformLocation(int program, const char * name) {
+    null_gl_calls[NULL_glGetUniformLocation] += 1;
+    return null_find(1, name, "location");
+}
+
+static void GL null_glLinkProgram(int a) { null_gl_calls[NULL_glLinkProgram] += 1; }
+static void GL null_glShaderSource(int a, int b, const void * c, const int * d) { null_gl_calls[NULL_glShaderSource] += 1; }
+static void GL null_glUseProgram(int a) { null_gl_calls[NULL_glUseProgram] += 1; }
+static void GL null_glUniform1i(int a, int b) { null_gl_calls[NULL_glUniform1i] += 1; }
+static void GL null_glUniform1fv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform1fv] += 1; }
+static void GL null_glUniform2fv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform2fv] += 1; }
+static void GL null_glUniform3fv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform3fv] += 1; }
+static void GL null_glUniform4fv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform4fv] += 1; }
+static void GL null_glUniform1iv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform1iv] += 1; }
+static void GL null_glUniform2iv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform2iv] += 1; }
+static void GL null_glUniform3iv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform3iv] += 1; }
+static void GL null_glUniform4iv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform4iv] += 1; }
+static void GL null_glUniformMatrix2fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix2fv] += 1; }
+static void GL null_glUniformMatrix3fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix3fv] += 1; }
+static void GL null_glUniformMatrix4fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix4fv] += 1; }
+static void GL null_glVertexAttribPointer(int a, int b, int c, int d, int e, intptr f) { null_gl_calls[NULL_glVertexAttribPointer] += 1; }
+static void GL null_glUniformMatrix2x3fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix2x3fv] += 1; }
+static void GL null_glUniformMatrix3x2fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix3x2fv] += 1; }
+static void GL null_glUniformMatrix2x4fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix2x4fv] += 1; }
+static void GL null_glUniformMatrix4x2fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix4x2fv] += 1; }
+static void GL null_glUniformMatrix3x4fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix3x4fv] += 1; }
+static void GL null_glUniformMatrix4x3fv(int a, int b, int c, const void * d) { null_gl_calls[NULL_glUniformMatrix4x3fv] += 1; }
+static void GL null_glBindBufferRange(int a, int b, int c, intptr d, intptr e) { null_gl_calls[NULL_glBindBufferRange] += 1; }
+static void GL null_glVertexAttribIPointer(int a, int b, int c, int d, intptr e) { null_gl_calls[NULL_glVertexAttribIPointer] += 1; }
+static void GL null_glUniform1uiv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform1uiv] += 1; }
+static void GL null_glUniform2uiv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform2uiv] += 1; }
+static void GL null_glUniform3uiv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform3uiv] += 1; }
+static void GL null_glUniform4uiv(int a, int b, const void * c) { null_gl_calls[NULL_glUniform4uiv] += 1; }
+static void GL null_glClearBufferiv(int a, int b, const void * c) { null_gl_calls[NULL_glClearBufferiv] += 1; }
+static void GL null_glClearBufferuiv(int a, int b, const void * c) { null_gl_calls[NULL_glClearBufferuiv] += 1; }
+static void GL null_glClearBufferfv(int a, int b, const void * c) { null_gl_calls[NULL_glClearBufferfv] += 1; }
+static void GL null_glClearBufferfi(int a, int b, float c, int d) { null_gl_calls[NULL_glClearBufferfi] += 1; }
+static void GL null_glBindRenderbuffer(int a, int b) { null_gl_calls[NULL_glBindRenderbuffer] += 1; }
+static void GL null_glDeleteRenderbuffers(int a, const int * b) { null_gl_calls[NULL_glDeleteRenderbuffers] += 1; }
+
+static void GL null_glGenRenderbuffers(int n, int * ids) {
+    null_gl_calls[NULL_glGenRenderbuffers] += 1;
+    null_gen(n, ids);
+}
+
+static void GL null_glBindFramebuffer(int a, int b) { null_gl_calls[NULL_glBindFramebuffer] += 1; }
+static void GL null_glDeleteFramebuffers(int a, const int * b) { null_gl_calls[NULL_glDeleteFramebuffers] += 1; }
+
+static void GL null_glGenFramebuffers(int n, int * ids) {
+    null_gl_calls[NULL_glGenFramebuffers] += 1;
+    null_gen(n, ids);
+}
+
+static void GL null_glFramebufferTexture2D(int a, int b, int c, int d, int e) { null_gl_calls[NULL_glFramebufferTexture2D] += 1; }
+static void GL null_glFramebufferRenderbuffer(int a, int b, int c, int d) { null_gl_calls[NULL_glFramebufferRenderbuffer] += 1; }
+static void GL null_glGenerateMipmap(int a) { null_gl_calls[NULL_glGenerateMipmap] += 1; }
+static void GL null_glBlitFramebuffer(int a, int b, int c, int d, int e, int f, int g, int h, int i, int j) { null_gl_calls[NULL_glBlitFramebuffer] += 1; }
+static void GL null_glRenderbufferStorageMultisample(int a, int b, int c, int d, int e) { null_gl_calls[NULL_glRenderbufferStorageMultisample] += 1; }
+static void GL null_glFramebufferTextureLayer(int a, int b, int c, int d, int e) { null_gl_calls[NULL_glFramebufferTextureLayer] += 1; }
+static void GL null_glBindVertexArray(int a) { null_gl_calls[NULL_glBindVertexArray] += 1; }
+static void GL null_glDeleteVertexArrays(int a, const int * b) { null_gl_calls[NULL_glDeleteVertexArrays] += 1; }
+
+static void GL null_glGenVertexArrays(int n, int * ids) {
+    null_gl_calls[NULL_glGenVertexArrays] += 1;
+    null_gen(n, ids);
+}
+
+static void GL null_glDrawArraysInstanced(int a, int b, int c, int d) { null_gl_calls[NULL_glDrawArraysInstanced] += 1; }
+static void GL null_glDrawElementsInstanced(int a, int b, int c, intptr d, int e) { null_gl_calls[NULL_glDrawElementsInstanced] += 1; }
+static void GL null_glMultiDrawArrays(int a, const int * b, const int * c, int d) { null_gl_calls[NULL_glMultiDrawArrays] += 1; }
+static void GL null_glMultiDrawElements(int a, const int * b, int c, const intptr * d, int e) { null_gl_calls[NULL_glMultiDrawElements] += 1; }
+static void GL null_glDrawElementsInstancedBaseVertex(int a, int b, int c, intptr d, int e, int f) { null_gl_calls[NULL_glDrawElementsInstancedBaseVertex] += 1; }
+static void GL null_glDrawArraysInstancedBaseInstance(int a, int b, int c, int d, int e) { null_gl_calls[NULL_glDrawArraysInstancedBaseInstance] += 1; }
+static void GL null_glDrawElementsInstancedBaseVertexBaseInstance(int a, int b, int c, intptr d, int e, int f, int g) { null_gl_calls[NULL_glDrawElementsInstancedBaseVertexBaseInstance] += 1; }
+static void GL null_glDrawArraysIndirect(int a, intptr b) { null_gl_calls[NULL_glDrawArraysIndirect] += 1; }
+static void GL null_glDrawElementsIndirect(int a, int b, intptr c) { null_gl_calls[NULL_glDrawElementsIndirect] += 1; }
+static void GL null_glMultiDrawArraysIndirect(int a, intptr b, int c, int d) { null_gl_calls[NULL_glMultiDrawArraysIndirect] += 1; }
+static void GL null_glMultiDrawElementsIndirect(int a, int b, intptr c, int d, int e) { null_gl_calls[NULL_glMultiDrawElementsIndirect] += 1; }
+static void GL null_glQueryCounter(int a, int b) { null_gl_calls[NULL_glQueryCounter] += 1; }
+
+static void GL null_glGetQueryObjectui64v(int id, int pname, void * params) {
+    null_gl_calls[NULL_glGetQueryObjectui64v] += 1;
+    *(unsigned long long *)params = 0;
+}
+
+static void GL null_glCopyBufferSubData(int a, int b, intptr c, intptr d, intptr e) { null_gl_calls[NULL_glCopyBufferSubData] += 1; }
+
+static int GL null_glGetUniformBlockIndex(int program, const char * name) {
+    null_gl_calls[NULL_glGetUniformBlockIndex] += 1;
+    return null_find(2, name, NULL);
+}
+
+static void GL null_glGetActiveUniformBlockiv(int program, int index, int pname, int * params) {
+    null_gl_calls[NULL_glGetActiveUniformBlockiv] += 1;
+    PyObject * item = null_item(2, index);
+    *params = pname == GL_UNIFORM_BLOCK_DATA_SIZE ? null_field(item, "size") : 0;
+    Py_XDECREF(item);
 }
 
+static void GL null_glGetActiveUniformBlockName(int program, int index, int bufsize, int * length, char * name) {
+    null_gl_calls[NULL_glGetActiveUniformBlockName] += 1;
+    PyObject * item = null_item(2, index);
+    null_name(item, bufsize, length, name);
+    Py_XDECREF(item);
+}
+
+static void GL null_glUniformBlockBinding(int a, int b, int c) { null_gl_calls[NULL_glUniformBlockBinding] += 1; }
+
+static void * GL null_glFenceSync(int condition, int flags) {
+    null_gl_calls[NULL_glFenceSync] += 1;
+    return (void *)(intptr)++null_gl_objects;
+}
+
+static void GL null_glDeleteSync(void * a) { null_gl_calls[NULL_glDeleteSync] += 1; }
+
+static int GL null_glClientWaitSync(void * sync, int flags, long long timeout) {
+    null_gl_calls[NULL_glClientWaitSync] += 1;
+    return GL_ALREADY_SIGNALED;
+}
+
+static void GL null_glGenSamplers(int n, int * ids) {
+    null_gl_calls[NULL_glGenSamplers] += 1;
+    null_gen(n, ids);
+}
+
+static void GL null_glDeleteSamplers(int a, const int * b) { null_gl_calls[NULL_glDeleteSamplers] += 1; }
+static void GL null_glBindSampler(int a, int b) { null_gl_calls[NULL_glBindSampler] += 1; }
+static void GL null_glSamplerParameteri(int a, int b, int c) { null_gl_calls[NULL_glSamplerParameteri] += 1; }
+static void GL null_glSamplerParameterf(int a, int b, float c) { null_gl_calls[NULL_glSamplerParameterf] += 1; }
+static void GL null_glVertexAttribDivisor(int a, int b) { null_gl_calls[NULL_glVertexAttribDivisor] += 1; }
+
+static const char * null_gl_names[] = {NULL_GL_FUNCTIONS(NULL_GL_NAME)};
+static void * null_gl_functions[] = {NULL_GL_FUNCTIONS(NULL_GL_FUNCTION)};
+
+#undef NULL_GL_FUNCTION
+#undef NULL_GL_NAME
+#undef NULL_GL_ENUM
+
 #endif
 
-static void bind_uniforms(Pipeline * self) {
+static int equalmem(const void * a, const void * b, int size) {
+    const unsigned char * x = a;
+    const unsigned char * y = b;
+    while (size--) {
+        if (*x++ != *y++) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void copymem(void * dst, const void * src, intptr size) {
+    unsigned char * x = dst;
+    const unsigned char * y = src;
+    while (size--) {
+        *x++ = *y++;
+    }
+}
+
+static void bind_uniforms(Pipeline * self, const char * data) {
     const UniformHeader * const header = (UniformHeader *)self->uniform_layout_buffer.buf;
-    const char * const data = (char *)self->uniform_data_buffer.buf;
+    char * const shadow = self->program->shadow;
     for (int i = 0; i < header->count; ++i) {
         const void * ptr = data + header->binding[i].offset;
+        int * uploaded = (int *)(shadow + header->binding[i].shadow);
+        if (*uploaded >= header->binding[i].count && equalmem(uploaded + 1, ptr, header->binding[i].size)) {
+            self->ctx->skipped_uniform_calls += 1;
+            continue;
+        }
+        copymem(uploaded + 1, ptr, header->binding[i].size);
+        if (*uploaded < header->binding[i].count) {
+            *uploaded = header->binding[i].count;
+        }
         switch (header->binding[i].function) {
             case 0: glUniform1iv(header->binding[i].location, header->binding[i].count, ptr); break;
             case 1: glUniform2iv(header->binding[i].location, header->binding[i].count, ptr); break;
@@ -700,10 +1533,18 @@ static int startswith(const char * str, const char * prefix) {
     return 1;
 }
 
+static int version_at_least(const char * version, char major, char minor) {
+    return version && (version[0] > major || (version[0] == major && version[2] >= minor));
+}
+
 static int to_int(PyObject * obj) {
     return (int)PyLong_AsLong(obj);
 }
 
+static intptr to_intptr(PyObject * obj) {
+    return PyLong_AsSsize_t(obj);
+}
+
 static unsigned to_uint(PyObject * obj) {
     return (unsigned)PyLong_AsUnsignedLong(obj);
 }
@@ -746,6 +1587,9 @@ static int get_image_format(PyObject * helper, PyObject * name, ImageFormat * re
     res->color = to_int(PyTuple_GetItem(tup, 6));
     res->flags = to_int(PyTuple_GetItem(tup, 7));
     res->clear_type = PyUnicode_AsUTF8AndSize(PyTuple_GetItem(tup, 8), NULL)[0];
+    res->compressed = PyTuple_Size(tup) > 9;
+    res->block_width = res->compressed ? to_int(PyTuple_GetItem(tup, 9)) : 1;
+    res->block_height = res->compressed ? to_int(PyTuple_GetItem(tup, 10)) : 1;
     return 1;
 }
 
@@ -781,18 +1625,6 @@ static int count_mipmaps(int width, int height) {
     return levels;
 }
 
-static void remove_dict_value(PyObject * dict, PyObject * obj) {
-    PyObject * key = NULL;
-    PyObject * value = NULL;
-    Py_ssize_t pos = 0;
-    while (PyDict_Next(dict, &pos, &key, &value)) {
-        if (value == obj) {
-            PyDict_DelItem(dict, key);
-            break;
-        }
-    }
-}
-
 static PyObject * new_ref(void * obj) {
     Py_INCREF(obj);
     return obj;
@@ -847,43 +1679,97 @@ static void bind_viewport(Context * self, Viewport * viewport) {
     }
 }
 
+static void bind_stencil(int face, StencilSettings * current, StencilSettings * stencil, int known) {
+    if (!known || current->write_mask != stencil->write_mask) {
+        glStencilMaskSeparate(face, stencil->write_mask);
+        current->write_mask = stencil->write_mask;
+    }
+    if (!known || current->compare_op != stencil->compare_op || current->reference != stencil->reference || current->compare_mask != stencil->compare_mask) {
+        glStencilFuncSeparate(face, stencil->compare_op, stencil->reference, stencil->compare_mask);
+        current->compare_op = stencil->compare_op;
+        current->reference = stencil->reference;
+        current->compare_mask = stencil->compare_mask;
+    }
+    if (!known || current->fail_op != stencil->fail_op || current->pass_op != stencil->pass_op || current->depth_fail_op != stencil->depth_fail_op) {
+        glStencilOpSeparate(face, stencil->fail_op, stencil->pass_op, stencil->depth_fail_op);
+        current->fail_op = stencil->fail_op;
+        current->pass_op = stencil->pass_op;
+        current->depth_fail_op = stencil->depth_fail_op;
+    }
+}
+
 static void bind_global_settings(Context * self, GlobalSettings * settings) {
     if (self->current_global_settings == settings) {
         return;
     }
-    if (settings->cull_face) {
-        glEnable(GL_CULL_FACE);
+    const int known = self->global_state_known;
+    const int cull_face_enabled = settings->cull_face != 0;
+    if (!known || self->current_cull_face_enabled != cull_face_enabled) {
+        if (cull_face_enabled) {
+            glEnable(GL_CULL_FACE);
+        } else {
+            glDisable(GL_CULL_FACE);
+        }
+        self->current_cull_face_enabled = cull_face_enabled;
+    }
+    if (cull_face_enabled && (!known || self->current_cull_face != settings->cull_face)) {
         glCullFace(settings->cull_face);
-    } else {
-        glDisable(GL_CULL_FACE);
+        self->current_cull_face = settings->cull_face;
+    }
+    if (!known || self->current_depth_enabled != settings->depth_enabled) {
+        if (settings->depth_enabled) {
+            glEnable(GL_DEPTH_TEST);
+        } else {
+            glDisable(GL_DEPTH_TEST);
+        }
+        self->current_depth_enabled = settings->depth_enabled;
     }
     if (settings->depth_enabled) {
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(settings->depth_func);
-        glDepthMask(settings->depth_write);
-        self->current_depth_mask = settings->depth_write;
-    } else {
-        glDisable(GL_DEPTH_TEST);
+        if (!known || self->current_depth_func != settings->depth_func) {
+            glDepthFunc(settings->depth_func);
+            self->current_depth_func = settings->depth_func;
+        }
+        if (!known || self->current_depth_mask != settings->depth_write) {
+            glDepthMask(settings->depth_write);
+            self->current_depth_mask = settings->depth_write;
+        }
+    }
+    if (!known || self->current_stencil_enabled != settings->stencil_enabled) {
+        if (settings->stencil_enabled) {
+            glEnable(GL_STENCIL_TEST);
+        } else {
+            glDisable(GL_STENCIL_TEST);
+        }
+        self->current_stencil_enabled = settings->stencil_enabled;
     }
     if (settings->stencil_enabled) {
-        glEnable(GL_STENCIL_TEST);
-        glStencilMaskSeparate(GL_FRONT, settings->stencil_front.write_mask);
-        glStencilMaskSeparate(GL_BACK, settings->stencil_back.write_mask);
-        glStencilFuncSeparate(GL_FRONT, settings->stencil_front.compare_op, settings->stencil_front.reference, settings->stencil_front.compare_mask);
-        glStencilFuncSeparate(GL_BACK, settings->stencil_back.compare_op, settings->stencil_back.reference, settings->stencil_back.compare_mask);
-        glStencilOpSeparate(GL_FRONT, settings->stencil_front.fail_op, settings->stencil_front.pass_op, settings->stencil_front.depth_fail_op);
-        glStencilOpSeparate(GL_BACK, settings->stencil_back.fail_op, settings->stencil_back.pass_op, settings->stencil_back.depth_fail_op);
-        self->current_stencil_mask = settings->stencil_front.write_mask;
-    } else {
-        glDisable(GL_STENCIL_TEST);
+        bind_stencil(GL_FRONT, &self->current_stencil_front, &settings->stencil_front, known);
+        bind_stencil(GL_BACK, &self->current_stencil_back, &settings->stencil_back, known);
+    }
+    if (!known || self->current_blend_enabled != settings->blend_enabled) {
+        if (settings->blend_enabled) {
+            glEnable(GL_BLEND);
+        } else {
+            glDisable(GL_BLEND);
+        }
+        self->current_blend_enabled = settings->blend_enabled;
     }
     if (settings->blend_enabled) {
-        glEnable(GL_BLEND);
-        glBlendEquationSeparate(settings->blend.op_color, settings->blend.op_alpha);
-        glBlendFuncSeparate(settings->blend.src_color, settings->blend.dst_color, settings->blend.src_alpha, settings->blend.dst_alpha);
-    } else {
-        glDisable(GL_BLEND);
+        BlendState * current = &self->current_blend;
+        if (!known || current->op_color != settings->blend.op_color || current->op_alpha != settings->blend.op_alpha) {
+            glBlendEquationSeparate(settings->blend.op_color, settings->blend.op_alpha);
+            current->op_color = settings->blend.op_color;
+            current->op_alpha = settings->blend.op_alpha;
+        }
+        if (!known || current->src_color != settings->blend.src_color || current->dst_color != settings->blend.dst_color || current->src_alpha != settings->blend.src_alpha || current->dst_alpha != settings->blend.dst_alpha) {
+            glBlendFuncSeparate(settings->blend.src_color, settings->blend.dst_color, settings->blend.src_alpha, settings->blend.dst_alpha);
+            current->src_color = settings->blend.src_color;
+            current->dst_color = settings->blend.dst_color;
+            current->src_alpha = settings->blend.src_alpha;
+            current->dst_alpha = settings->blend.dst_alpha;
+        }
     }
+    self->global_state_known = 1;
     self->current_global_settings = settings;
 }
 
@@ -901,6 +1787,31 @@ static void bind_draw_framebuffer(Context * self, int framebuffer) {
     }
 }
 
+static void bind_framebuffer_srgb(Context * self, int srgb) {
+    if (self->current_framebuffer_srgb != srgb && !self->is_gles && !self->is_webgl) {
+        self->current_framebuffer_srgb = srgb;
+        if (srgb) {
+            glEnable(GL_FRAMEBUFFER_SRGB);
+        } else {
+            glDisable(GL_FRAMEBUFFER_SRGB);
+        }
+    }
+}
+
+static int is_srgb_attachment(PyObject * attachments) {
+    if (attachments == Py_None) {
+        return 0;
+    }
+    PyObject * color_attachments = PyTuple_GetItem(attachments, 1);
+    for (int i = 0; i < (int)PyTuple_Size(color_attachments); ++i) {
+        ImageFace * face = (ImageFace *)PyTuple_GetItem(color_attachments, i);
+        if (face->image->fmt.internal_format == GL_SRGB8_ALPHA8) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
 static void bind_program(Context * self, int program) {
     if (self->current_program != program) {
         self->current_program = program;
@@ -915,60 +1826,259 @@ static void bind_vertex_array(Context * self, int vertex_array) {
     }
 }
 
+static void reset_descriptor_slots(Context * self) {
+    for (int i = 0; i < MAX_SAMPLER_BINDINGS; ++i) {
+        self->current_textures[i] = -1;
+        self->current_samplers[i] = -1;
+    }
+    for (int i = 0; i < MAX_BUFFER_BINDINGS; ++i) {
+        self->current_uniform_buffers[i].buffer = -1;
+    }
+}
+
+static void bind_default_texture(Context * self, int target, int texture) {
+    int unit = self->default_texture_unit - GL_TEXTURE0;
+    if (unit < MAX_SAMPLER_BINDINGS) {
+        self->current_textures[unit] = -1;
+    }
+    glActiveTexture(self->default_texture_unit);
+    glBindTexture(target, texture);
+}
+
 static void bind_descriptor_set(Context * self, DescriptorSet * set) {
     if (self->current_descriptor_set != set) {
         self->current_descriptor_set = set;
-        if (set->uniform_buffers.binding_count) {
-            for (int i = 0; i < set->uniform_buffers.binding_count; ++i) {
-                if (set->uniform_buffers.binding[i].buffer) {
-                    glBindBufferRange(
-                        GL_UNIFORM_BUFFER,
-                        i,
-                        set->uniform_buffers.binding[i].buffer->buffer,
-                        set->uniform_buffers.binding[i].offset,
-                        set->uniform_buffers.binding[i].size
-                    );
-                }
+        for (int i = 0; i < set->uniform_buffers.binding_count; ++i) {
+            BufferBinding * binding = &set->uniform_buffers.binding[i];
+            UniformBufferSlot * current = &self->current_uniform_buffers[i];
+            if (binding->buffer && !binding->dynamic && (current->buffer != binding->buffer->buffer || current->offset != binding->offset || current->size != binding->size)) {
+                current->buffer = binding->buffer->buffer;
+                current->offset = binding->offset;
+                current->size = binding->size;
+                glBindBufferRange(GL_UNIFORM_BUFFER, i, binding->buffer->buffer, binding->offset, binding->size);
             }
         }
-        if (set->samplers.binding_count) {
-            for (int i = 0; i < set->samplers.binding_count; ++i) {
-                if (set->samplers.binding[i].image) {
+        for (int i = 0; i < set->samplers.binding_count; ++i) {
+            SamplerBinding * binding = &set->samplers.binding[i];
+            if (binding->image) {
+                if (self->current_textures[i] != binding->image->image) {
+                    self->current_textures[i] = binding->image->image;
                     glActiveTexture(GL_TEXTURE0 + i);
-                    glBindTexture(set->samplers.binding[i].image->target, set->samplers.binding[i].image->image);
-                    glBindSampler(i, set->samplers.binding[i].sampler->obj);
+                    glBindTexture(binding->image->target, binding->image->image);
+                }
+                if (self->current_samplers[i] != binding->sampler->obj) {
+                    self->current_samplers[i] = binding->sampler->obj;
+                    glBindSampler(i, binding->sampler->obj);
                 }
             }
         }
     }
 }
 
-static GLObject * build_framebuffer(Context * self, PyObject * attachments) {
-    GLObject * cache = (GLObject *)PyDict_GetItem(self->framebuffer_cache, attachments);
-    if (cache) {
-        cache->uses += 1;
-        Py_INCREF((PyObject *)cache);
-        return cache;
+static void bind_dynamic_uniform_buffers(Context * self, DescriptorSet * set, intptr dynamic_offset) {
+    for (int i = 0; i < set->uniform_buffers.binding_count; ++i) {
+        BufferBinding * binding = &set->uniform_buffers.binding[i];
+        UniformBufferSlot * current = &self->current_uniform_buffers[i];
+        intptr offset = binding->offset + dynamic_offset;
+        if (binding->dynamic && (current->buffer != binding->buffer->buffer || current->offset != offset || current->size != binding->size)) {
+            current->buffer = binding->buffer->buffer;
+            current->offset = offset;
+            current->size = binding->size;
+            glBindBufferRange(GL_UNIFORM_BUFFER, i, binding->buffer->buffer, offset, binding->size);
+        }
     }
+}
 
-    PyObject * color_attachments = PyTuple_GetItem(attachments, 1);
-    PyObject * depth_stencil_attachment = PyTuple_GetItem(attachments, 2);
+static void bind_pipeline(Pipeline * self, Viewport * viewport, const char * uniform_data, intptr dynamic_offset) {
+    bind_viewport(self->ctx, viewport);
+    bind_global_settings(self->ctx, self->global_settings);
+    bind_draw_framebuffer(self->ctx, self->framebuffer->obj);
+    bind_framebuffer_srgb(self->ctx, self->srgb);
+    bind_program(self->ctx, self->program->obj);
+    bind_vertex_array(self->ctx, self->vertex_array->obj);
+    bind_descriptor_set(self->ctx, self->descriptor_set);
+    if (self->descriptor_set->uniform_buffers.dynamic) {
+        bind_dynamic_uniform_buffers(self->ctx, self->descriptor_set, dynamic_offset);
+    }
+    if (self->uniforms) {
+        bind_uniforms(self, uniform_data);
+    }
+}
 
-    int framebuffer = 0;
-    glGenFramebuffers(1, &framebuffer);
-    bind_draw_framebuffer(self, framebuffer);
-    bind_read_framebuffer(self, framebuffer);
-    int color_attachment_count = (int)PyTuple_Size(color_attachments);
-    for (int i = 0; i < color_attachment_count; ++i) {
-        ImageFace * face = (ImageFace *)PyTuple_GetItem(color_attachments, i);
-        if (face->image->renderbuffer) {
-            glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_RENDERBUFFER, face->image->image);
-        } else if (face->image->cubemap) {
-            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face->layer, face->image->image, face->level);
-        } else if (face->image->array) {
-            glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, face->image->image, face->level, face->layer);
+static void draw_pipeline(Pipeline * self, RenderParameters * params, int base_draws) {
+    const int base_vertex = base_draws && self->ctx->base_vertex_support ? params->base_vertex : 0;
+    const int base_instance = base_draws && self->ctx->base_instance_support ? params->base_instance : 0;
+    if (self->index_type) {
+        intptr offset = (intptr)params->first_vertex * (intptr)self->index_size + (intptr)self->index_offset;
+        if (base_instance) {
+            glDrawElementsInstancedBaseVertexBaseInstance(self->topology, params->vertex_count, self->index_type, offset, params->instance_count, base_vertex, base_instance);
+        } else if (base_vertex) {
+            glDrawElementsInstancedBaseVertex(self->topology, params->vertex_count, self->index_type, offset, params->instance_count, base_vertex);
         } else {
-            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, face->image->image, face->level);
+            glDrawElementsInstanced(self->topology, params->vertex_count, self->index_type, offset, params->instance_count);
+        }
+    } else if (base_instance) {
+        glDrawArraysInstancedBaseInstance(self->topology, params->first_vertex, params->vertex_count, params->instance_count, base_instance);
+    } else {
+        glDrawArraysInstanced(self->topology, params->first_vertex, params->vertex_count, params->instance_count);
+    }
+}
+
+static void draw_pipeline_indirect(Pipeline * self, int indirect_count) {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, self->indirect_buffer->buffer);
+    intptr offset = self->indirect_offset;
+    if (self->index_type) {
+        if (self->ctx->multi_draw_indirect_support && indirect_count > 1) {
+            glMultiDrawElementsIndirect(self->topology, self->index_type, offset, indirect_count, 0);
+        } else {
+            for (int i = 0; i < indirect_count; ++i) {
+                glDrawElementsIndirect(self->topology, self->index_type, offset + i * 20);
+            }
+        }
+    } else {
+        if (self->ctx->multi_draw_indirect_support && indirect_count > 1) {
+            glMultiDrawArraysIndirect(self->topology, offset, indirect_count, 0);
+        } else {
+            for (int i = 0; i < indirect_count; ++i) {
+                glDrawArraysIndirect(self->topology, offset + i * 16);
+            }
+        }
+    }
+}
+
+static int acquire_profile_query(Context * self) {
+    if (self->profile_query_count) {
+        self->profile_query_count -= 1;
+        return self->profile_queries[self->profile_query_count];
+    }
+    int query = 0;
+    glGenQueries(1, &query);
+    return query;
+}
+
+static int profile_begin(Context * self, const char * name, PyObject * label) {
+    if (!self->profile_running) {
+        return -1;
+    }
+    if (self->profile_event_count == self->profile_event_capacity) {
+        int capacity = self->profile_event_capacity ? self->profile_event_capacity * 2 : 64;
+        ProfileEvent * events = (ProfileEvent *)PyMem_Realloc(self->profile_events, (size_t)capacity * sizeof(ProfileEvent));
+        if (!events) {
+            return -1;
+        }
+        self->profile_events = events;
+        int * queries = (int *)PyMem_Realloc(self->profile_queries, (size_t)capacity * 2 * sizeof(int));
+        if (!queries) {
+            return -1;
+        }
+        self->profile_queries = queries;
+        self->profile_event_capacity = capacity;
+    }
+    int index = self->profile_event_count++;
+    ProfileEvent * event = &self->profile_events[index];
+    event->label = label != Py_None ? label : NULL;
+    event->name = name;
+    event->begin_query = acquire_profile_query(self);
+    event->end_query = 0;
+    event->frame = self->frame_index;
+    Py_XINCREF(event->label);
+    glQueryCounter(event->begin_query, GL_TIMESTAMP);
+    return index;
+}
+
+static void profile_end(Context * self, int index) {
+    if (index < 0) {
+        return;
+    }
+    ProfileEvent * event = &self->profile_events[index];
+    event->end_query = acquire_profile_query(self);
+    glQueryCounter(event->end_query, GL_TIMESTAMP);
+}
+
+static void render_pipeline(Pipeline * self) {
+    int event = profile_begin(self->ctx, "render", self->label);
+    bind_pipeline(self, (Viewport *)self->viewport_data_buffer.buf, (char *)self->uniform_data_buffer.buf, self->dynamic_offset);
+    if (self->indirect_buffer) {
+        draw_pipeline_indirect(self, self->indirect_count);
+    } else {
+        draw_pipeline(self, (RenderParameters *)self->render_data_buffer.buf, self->base_draws);
+    }
+    profile_end(self->ctx, event);
+}
+
+static void render_command(DrawCommand * command, const char * uniform_data) {
+    Pipeline * self = command->pipeline;
+    int event = profile_begin(self->ctx, "render", self->label);
+    bind_pipeline(self, &command->viewport, uniform_data ? uniform_data + command->uniform_offset : NULL, command->dynamic_offset);
+    if (self->indirect_buffer) {
+        draw_pipeline_indirect(self, command->indirect_count);
+    } else {
+        draw_pipeline(self, &command->params, self->base_draws);
+    }
+    profile_end(self->ctx, event);
+}
+
+static int multi_draw_pipeline(Pipeline * self, RenderParameters * params, int count) {
+    for (int i = 0; i < count; ++i) {
+        if (params[i].instance_count != 1 || params[i].base_vertex || params[i].base_instance) {
+            return 0;
+        }
+    }
+
+    int * counts = (int *)PyMem_Malloc((size_t)count * sizeof(int));
+    int * firsts = (int *)PyMem_Malloc((size_t)count * sizeof(int));
+    intptr * offsets = (intptr *)PyMem_Malloc((size_t)count * sizeof(intptr));
+    if (!counts || !firsts || !offsets) {
+        PyMem_Free(counts);
+        PyMem_Free(firsts);
+        PyMem_Free(offsets);
+        return 0;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        counts[i] = params[i].vertex_count;
+        firsts[i] = params[i].first_vertex;
+        offsets[i] = (intptr)params[i].first_vertex * (intptr)self->index_size + (intptr)self->index_offset;
+    }
+
+    if (self->index_type) {
+        glMultiDrawElements(self->topology, counts, self->index_type, offsets, count);
+    } else {
+        glMultiDrawArrays(self->topology, firsts, counts, count);
+    }
+
+    PyMem_Free(counts);
+    PyMem_Free(firsts);
+    PyMem_Free(offsets);
+    return 1;
+}
+
+static GLObject * build_framebuffer(Context * self, PyObject * attachments) {
+    GLObject * cache = (GLObject *)PyDict_GetItem(self->framebuffer_cache, attachments);
+    if (cache) {
+        cache->uses += 1;
+        Py_INCREF((PyObject *)cache);
+        return cache;
+    }
+
+    PyObject * color_attachments = PyTuple_GetItem(attachments, 1);
+    PyObject * depth_stencil_attachment = PyTuple_GetItem(attachments, 2);
+
+    int framebuffer = 0;
+    glGenFramebuffers(1, &framebuffer);
+    bind_draw_framebuffer(self, framebuffer);
+    bind_read_framebuffer(self, framebuffer);
+    int color_attachment_count = (int)PyTuple_Size(color_attachments);
+    for (int i = 0; i < color_attachment_count; ++i) {
+        ImageFace * face = (ImageFace *)PyTuple_GetItem(color_attachments, i);
+        if (face->image->renderbuffer) {
+            glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_RENDERBUFFER, face->image->image);
+        } else if (face->image->cubemap) {
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face->layer, face->image->image, face->level);
+        } else if (face->image->array) {
+            glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, face->image->image, face->level, face->layer);
+        } else {
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, face->image->image, face->level);
         }
     }
 
@@ -999,6 +2109,8 @@ static GLObject * build_framebuffer(Context * self, PyObject * attachments) {
     res->obj = framebuffer;
     res->uses = 1;
     res->extra = NULL;
+    res->key = new_ref(attachments);
+    res->shadow = NULL;
 
     PyDict_SetItem(self->framebuffer_cache, attachments, (PyObject *)res);
     return res;
@@ -1022,7 +2134,7 @@ static GLObject * build_vertex_array(Context * self, PyObject * bindings) {
     for (int i = 1; i < length; i += 6) {
         Buffer * buffer = (Buffer *)PyTuple_GetItem(bindings, i + 0);
         int location = to_int(PyTuple_GetItem(bindings, i + 1));
-        int offset = to_int(PyTuple_GetItem(bindings, i + 2));
+        intptr offset = to_intptr(PyTuple_GetItem(bindings, i + 2));
         int stride = to_int(PyTuple_GetItem(bindings, i + 3));
         int divisor = to_int(PyTuple_GetItem(bindings, i + 4));
         VertexFormat fmt;
@@ -1032,9 +2144,9 @@ static GLObject * build_vertex_array(Context * self, PyObject * bindings) {
         }
         glBindBuffer(GL_ARRAY_BUFFER, buffer->buffer);
         if (fmt.integer) {
-            glVertexAttribIPointer(location, fmt.size, fmt.type, stride, (intptr)offset);
+            glVertexAttribIPointer(location, fmt.size, fmt.type, stride, offset);
         } else {
-            glVertexAttribPointer(location, fmt.size, fmt.type, fmt.normalize, stride, (intptr)offset);
+            glVertexAttribPointer(location, fmt.size, fmt.type, fmt.normalize, stride, offset);
         }
         glVertexAttribDivisor(location, divisor);
         glEnableVertexAttribArray(location);
@@ -1049,6 +2161,8 @@ static GLObject * build_vertex_array(Context * self, PyObject * bindings) {
     res->obj = vertex_array;
     res->uses = 1;
     res->extra = NULL;
+    res->key = new_ref(bindings);
+    res->shadow = NULL;
 
     PyDict_SetItem(self->vertex_array_cache, bindings, (PyObject *)res);
     return res;
@@ -1089,6 +2203,8 @@ static GLObject * build_sampler(Context * self, PyObject * params) {
     res->obj = sampler;
     res->uses = 1;
     res->extra = NULL;
+    res->key = new_ref(params);
+    res->shadow = NULL;
 
     PyDict_SetItem(self->sampler_cache, params, (PyObject *)res);
     return res;
@@ -1100,14 +2216,17 @@ static DescriptorSetBuffers build_descriptor_set_buffers(Context * self, PyObjec
 
     int length = (int)PyTuple_Size(bindings);
 
-    for (int i = 0; i < length; i += 4) {
+    for (int i = 0; i < length; i += 5) {
         int binding = to_int(PyTuple_GetItem(bindings, i + 0));
         Buffer * buffer = (Buffer *)PyTuple_GetItem(bindings, i + 1);
-        int offset = to_int(PyTuple_GetItem(bindings, i + 2));
-        int size = to_int(PyTuple_GetItem(bindings, i + 3));
+        intptr offset = to_intptr(PyTuple_GetItem(bindings, i + 2));
+        intptr size = to_intptr(PyTuple_GetItem(bindings, i + 3));
+        int dynamic = to_int(PyTuple_GetItem(bindings, i + 4));
         res.binding[binding].buffer = (Buffer *)new_ref(buffer);
         res.binding[binding].offset = offset;
         res.binding[binding].size = size;
+        res.binding[binding].dynamic = dynamic;
+        res.dynamic = res.dynamic || dynamic;
         res.binding_count = res.binding_count > (binding + 1) ? res.binding_count : (binding + 1);
     }
 
@@ -1144,6 +2263,7 @@ static DescriptorSet * build_descriptor_set(Context * self, PyObject * bindings)
     res->uniform_buffers = build_descriptor_set_buffers(self, PyTuple_GetItem(bindings, 0));
     res->samplers = build_descriptor_set_samplers(self, PyTuple_GetItem(bindings, 1));
     res->uses = 1;
+    res->key = new_ref(bindings);
 
     PyDict_SetItem(self->descriptor_set_cache, bindings, (PyObject *)res);
     return res;
@@ -1159,6 +2279,7 @@ static GlobalSettings * build_global_settings(Context * self, PyObject * setting
 
     GlobalSettings * res = PyObject_New(GlobalSettings, self->module_state->GlobalSettings_type);
     res->uses = 1;
+    res->key = new_ref(settings);
 
     int it = 0;
     res->attachments = to_int(PyTuple_GetItem(settings, it++));
@@ -1230,6 +2351,8 @@ static GLObject * compile_shader(Context * self, PyObject * pair) {
     res->obj = shader;
     res->uses = 1;
     res->extra = NULL;
+    res->key = new_ref(pair);
+    res->shadow = NULL;
 
     PyDict_SetItem(self->shader_cache, pair, (PyObject *)res);
     return res;
@@ -1281,6 +2404,85 @@ static PyObject * program_interface(Context * self, int program) {
     return Py_BuildValue("(NNN)", attributes, uniforms, uniform_buffers);
 }
 
+static GLObject * load_program_binary(Context * self, PyObject * key) {
+    PyObject * entry = PyObject_CallMethod(self->module_state->helper, "load_program_binary", "(OOO)", self->program_binary_cache, key, self->info_dict);
+    if (!entry) {
+        return NULL;
+    }
+
+    if (entry == Py_None) {
+        Py_DECREF(entry);
+        return NULL;
+    }
+
+    int binary_format = to_int(PyTuple_GetItem(entry, 0));
+    PyObject * binary = PyTuple_GetItem(entry, 1);
+
+    int program = glCreateProgram();
+    glProgramBinary(program, binary_format, PyBytes_AsString(binary), (int)PyBytes_Size(binary));
+
+    int linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+    if (!linked) {
+        glGetError();
+        glDeleteProgram(program);
+        Py_DECREF(entry);
+        Py_XDECREF(PyObject_CallMethod(self->module_state->helper, "remove_program_binary", "(OOO)", self->program_binary_cache, key, self->info_dict));
+        return NULL;
+    }
+
+    bind_program(self, program);
+
+    GLObject * res = PyObject_New(GLObject, self->module_state->GLObject_type);
+    res->obj = program;
+    res->uses = 1;
+    res->extra = new_ref(PyTuple_GetItem(entry, 2));
+    res->key = new_ref(key);
+    res->shadow = NULL;
+
+    Py_DECREF(entry);
+    return res;
+}
+
+static int save_program_binary(Context * self, PyObject * key, GLObject * program) {
+    int binary_size = 0;
+    glGetProgramiv(program->obj, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+    if (binary_size <= 0) {
+        return 1;
+    }
+
+    char * binary = (char *)PyMem_Malloc((size_t)binary_size);
+    if (!binary) {
+        PyErr_NoMemory();
+        return 0;
+    }
+
+    int binary_format = 0;
+    glGetProgramBinary(program->obj, binary_size, &binary_size, &binary_format, binary);
+    PyObject * data = PyBytes_FromStringAndSize(binary, binary_size);
+    PyMem_Free(binary);
+
+    PyObject * res = PyObject_CallMethod(
+        self->module_state->helper,
+        "save_program_binary",
+        "(OOOiNO)",
+        self->program_binary_cache,
+        key,
+        self->info_dict,
+        binary_format,
+        data,
+        program->extra
+    );
+
+    if (!res) {
+        return 0;
+    }
+
+    Py_DECREF(res);
+    return 1;
+}
+
 static GLObject * compile_program(Context * self, PyObject * includes, PyObject * vert, PyObject * frag, PyObject * layout) {
     PyObject * tup = PyObject_CallMethod(self->module_state->helper, "program", "(OOOO)", vert, frag, layout, includes);
     if (!tup) {
@@ -1291,9 +2493,25 @@ static GLObject * compile_program(Context * self, PyObject * includes, PyObject
     if (cache) {
         cache->uses += 1;
         Py_INCREF((PyObject *)cache);
+        Py_DECREF(tup);
         return cache;
     }
 
+    int use_program_binary = self->program_binary_support && self->program_binary_cache != Py_None;
+
+    if (use_program_binary) {
+        GLObject * res = load_program_binary(self, tup);
+        if (res) {
+            PyDict_SetItem(self->program_cache, tup, (PyObject *)res);
+            Py_DECREF(tup);
+            return res;
+        }
+        if (PyErr_Occurred()) {
+            Py_DECREF(tup);
+            return NULL;
+        }
+    }
+
     PyObject * vert_pair = PyTuple_GetItem(tup, 0);
     PyObject * frag_pair = PyTuple_GetItem(tup, 1);
 
@@ -1316,10 +2534,14 @@ static GLObject * compile_program(Context * self, PyObject * includes, PyObject
     int program = glCreateProgram();
     glAttachShader(program, vertex_shader_obj);
     glAttachShader(program, fragment_shader_obj);
-    glLinkProgram(program);
-
+    if (use_program_binary) {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, 1);
+    }
     int linked = 0;
+    Py_BEGIN_ALLOW_THREADS
+    glLinkProgram(program);
     glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    Py_END_ALLOW_THREADS
 
     if (!linked) {
         int log_size = 0;
@@ -1336,8 +2558,16 @@ static GLObject * compile_program(Context * self, PyObject * includes, PyObject
     res->obj = program;
     res->uses = 1;
     res->extra = program_interface(self, program);
+    res->key = new_ref(tup);
+    res->shadow = NULL;
 
     PyDict_SetItem(self->program_cache, tup, (PyObject *)res);
+
+    if (use_program_binary && !save_program_binary(self, tup, res)) {
+        Py_DECREF(tup);
+        return NULL;
+    }
+
     Py_DECREF(tup);
     return res;
 }
@@ -1382,15 +2612,18 @@ static ImageFace * build_image_face(Image * self, PyObject * key) {
 
 static void clear_bound_image(Image * self) {
     const int depth_mask = self->ctx->current_depth_mask != 1 && (self->fmt.buffer == GL_DEPTH || self->fmt.buffer == GL_DEPTH_STENCIL);
-    const int stencil_mask = self->ctx->current_stencil_mask != 0xff && (self->fmt.buffer == GL_STENCIL || self->fmt.buffer == GL_DEPTH_STENCIL);
+    const int stencil_mask = self->ctx->current_stencil_front.write_mask != 0xff && (self->fmt.buffer == GL_STENCIL || self->fmt.buffer == GL_DEPTH_STENCIL);
     if (depth_mask) {
         glDepthMask(1);
         self->ctx->current_depth_mask = 1;
+        self->ctx->current_global_settings = NULL;
     }
     if (stencil_mask) {
         glStencilMaskSeparate(GL_FRONT, 0xff);
-        self->ctx->current_stencil_mask = 0xff;
+        self->ctx->current_stencil_front.write_mask = 0xff;
+        self->ctx->current_global_settings = NULL;
     }
+    bind_framebuffer_srgb(self->ctx, self->fmt.internal_format == GL_SRGB8_ALPHA8);
     if (self->fmt.clear_type == 'f') {
         glClearBufferfv(self->fmt.buffer, 0, self->clear_value.clear_floats);
     } else if (self->fmt.clear_type == 'i') {
@@ -1451,6 +2684,16 @@ static PyObject * blit_image_face(ImageFace * src, PyObject * dst, PyObject * sr
         return NULL;
     }
 
+    if (src->image->fmt.compressed || (target && target->image->fmt.compressed)) {
+        PyErr_Format(PyExc_TypeError, "cannot blit compressed images");
+        return NULL;
+    }
+
+    if (src->image->fmt.clear_type == 'e' || (target && target->image->fmt.clear_type == 'e')) {
+        PyErr_Format(PyExc_TypeError, "cannot blit shared exponent images");
+        return NULL;
+    }
+
     if (target && !target->image->fmt.color) {
         PyErr_Format(PyExc_TypeError, "cannot blit to depth or stencil images");
         return NULL;
@@ -1462,13 +2705,16 @@ static PyObject * blit_image_face(ImageFace * src, PyObject * dst, PyObject * sr
     }
 
     int target_framebuffer = target ? target->framebuffer->obj : src->ctx->default_framebuffer->obj;
+    int event = profile_begin(src->ctx, "blit", Py_None);
     bind_read_framebuffer(src->image->ctx, src->framebuffer->obj);
     bind_draw_framebuffer(src->image->ctx, target_framebuffer);
+    bind_framebuffer_srgb(src->ctx, target && target->image->fmt.internal_format == GL_SRGB8_ALPHA8);
     glBlitFramebuffer(
         sv.x, sv.y, sv.x + sv.width, sv.y + sv.height,
         tv.x, tv.y, tv.x + tv.width, tv.y + tv.height,
         GL_COLOR_BUFFER_BIT, filter ? GL_LINEAR : GL_NEAREST
     );
+    profile_end(src->ctx, event);
 
     Py_RETURN_NONE;
 }
@@ -1504,39 +2750,185 @@ static int parse_size_and_offset(ImageFace * self, PyObject * size_arg, PyObject
     return 1;
 }
 
-static PyObject * read_image_face(ImageFace * src, IntPair size, IntPair offset, PyObject * into) {
-    if (src->image->samples > 1) {
-        PyObject * temp = PyObject_CallMethod((PyObject *)src->image->ctx, "image", "((ii)O)", size.x, size.y, src->image->format);
-        if (!temp) {
-            return NULL;
+static void buffer_sub_data(int target, intptr offset, intptr size, const char * ptr) {
+    while (size > 0) {
+        const intptr chunk = size < MAX_TRANSFER_SIZE ? size : MAX_TRANSFER_SIZE;
+        glBufferSubData(target, offset, chunk, ptr);
+        offset += chunk;
+        ptr += chunk;
+        size -= chunk;
+    }
+}
+
+static void get_buffer_sub_data(int target, intptr offset, intptr size, char * ptr) {
+    while (size > 0) {
+        const intptr chunk = size < MAX_TRANSFER_SIZE ? size : MAX_TRANSFER_SIZE;
+        glGetBufferSubData(target, offset, chunk, ptr);
+        offset += chunk;
+        ptr += chunk;
+        size -= chunk;
+    }
+}
+
+static int get_strided_pixels(Image * self, PyObject * obj, IntPair size, int layers, int writable, Py_buffer * view, intptr * row_stride, intptr * layer_stride) {
+    if (self->fmt.compressed || !PyObject_CheckBuffer(obj)) {
+        return 0;
+    }
+    if (PyObject_GetBuffer(obj, view, writable ? PyBUF_STRIDED : PyBUF_STRIDED_RO)) {
+        PyErr_Clear();
+        return 0;
+    }
+    const intptr row_size = (intptr)size.x * (intptr)self->fmt.pixel_size;
+    intptr extent = view->itemsize;
+    int dim = view->ndim - 1;
+    while (dim >= 0 && extent < row_size && view->strides[dim] == extent) {
+        extent *= view->shape[dim];
+        dim -= 1;
+    }
+    int valid = (!PyBuffer_IsContiguous(view, 'C') || row_size % 4) && extent == row_size && dim >= 0 && view->shape[dim] == size.y;
+    if (valid) {
+        *row_stride = view->strides[dim];
+        *layer_stride = *row_stride * size.y;
+        if (dim == 1) {
+            valid = view->shape[0] == layers;
+            *layer_stride = view->strides[0];
+        } else {
+            valid = dim == 0 && layers == 1;
         }
+    }
+    valid = valid && *row_stride >= row_size && *row_stride % self->fmt.pixel_size == 0;
+    valid = valid && *layer_stride >= *row_stride * size.y && *layer_stride % *row_stride == 0;
+    if (!valid) {
+        PyBuffer_Release(view);
+        return 0;
+    }
+    return 1;
+}
 
-        PyObject * blit = PyObject_CallMethod((PyObject *)src, "blit", "(O(iiii)(iiii))", temp, 0, 0, size.x, size.y, offset.x, offset.y, size.x, size.y);
-        if (!blit) {
-            return NULL;
+static void read_pixels(ImageFace * src, IntPair size, IntPair offset, void * ptr) {
+    int event = profile_begin(src->ctx, "read", Py_None);
+    Py_BEGIN_ALLOW_THREADS
+    glReadPixels(offset.x, offset.y, size.x, size.y, src->image->fmt.format, src->image->fmt.type, ptr);
+    Py_END_ALLOW_THREADS
+    profile_end(src->ctx, event);
+}
+
+static void release_framebuffer(Context * self, GLObject * framebuffer) {
+    framebuffer->uses -= 1;
+    if (!framebuffer->uses) {
+        PyDict_DelItem(self->framebuffer_cache, framebuffer->key);
+        if (framebuffer->obj) {
+            bind_draw_framebuffer(self, 0);
+            bind_read_framebuffer(self, 0);
+            glDeleteFramebuffers(1, &framebuffer->obj);
         }
-        Py_DECREF(blit);
+        self->current_viewport.x = -1;
+        self->current_viewport.y = -1;
+        self->current_viewport.width = -1;
+        self->current_viewport.height = -1;
+    }
+}
 
-        PyObject * res = PyObject_CallMethod(temp, "read", "(OOO)", Py_None, Py_None, into);
-        if (!res) {
+static void release_image(Context * self, Image * image) {
+    if (image->resolve_target) {
+        release_image(self, image->resolve_target);
+        Py_DECREF(image->resolve_target);
+        image->resolve_target = NULL;
+    }
+    if (image->faces) {
+        PyObject * key = NULL;
+        PyObject * value = NULL;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(image->faces, &pos, &key, &value)) {
+            ImageFace * face = (ImageFace *)value;
+            release_framebuffer(self, face->framebuffer);
+        }
+        PyDict_Clear(image->faces);
+    }
+    if (image->renderbuffer) {
+        glDeleteRenderbuffers(1, &image->image);
+    } else {
+        for (int i = 0; i < MAX_SAMPLER_BINDINGS; ++i) {
+            if (self->current_textures[i] == image->image) {
+                self->current_textures[i] = -1;
+            }
+        }
+        glDeleteTextures(1, &image->image);
+    }
+}
+
+static ImageFace * resolve_image_face(ImageFace * src, IntPair size, IntPair offset) {
+    Image * image = src->image;
+    Context * ctx = image->ctx;
+
+    if (!image->fmt.color) {
+        PyErr_Format(PyExc_TypeError, "cannot resolve depth or stencil images");
+        return NULL;
+    }
+
+    Image * target = image->resolve_target;
+    if (target && (target->width < size.x || target->height < size.y)) {
+        size.x = target->width > size.x ? target->width : size.x;
+        size.y = target->height > size.y ? target->height : size.y;
+        release_image(ctx, target);
+        Py_DECREF(target);
+        image->resolve_target = target = NULL;
+    }
+
+    if (!target) {
+        target = (Image *)PyObject_CallMethod((PyObject *)ctx, "image", "((ii)O)", size.x, size.y, image->format);
+        if (!target) {
             return NULL;
         }
+        target->gc_prev->gc_next = target->gc_next;
+        target->gc_next->gc_prev = target->gc_prev;
+        target->gc_prev = (GCHeader *)target;
+        target->gc_next = (GCHeader *)target;
+        Py_DECREF(target);
+        image->resolve_target = target;
+    }
+
+    ImageFace * res = (ImageFace *)PyTuple_GetItem(target->layers, 0);
+    int event = profile_begin(ctx, "resolve", Py_None);
+    bind_read_framebuffer(ctx, src->framebuffer->obj);
+    bind_draw_framebuffer(ctx, res->framebuffer->obj);
+    bind_framebuffer_srgb(ctx, res->image->fmt.internal_format == GL_SRGB8_ALPHA8);
+    glBlitFramebuffer(
+        offset.x, offset.y, offset.x + size.x, offset.y + size.y,
+        0, 0, size.x, size.y,
+        GL_COLOR_BUFFER_BIT, GL_NEAREST
+    );
+    profile_end(ctx, event);
+    return res;
+}
+
+static PyObject * read_image_face(ImageFace * src, IntPair size, IntPair offset, PyObject * into) {
+    if (src->image->fmt.compressed) {
+        PyErr_Format(PyExc_TypeError, "cannot read compressed images");
+        return NULL;
+    }
+
+    if (src->image->fmt.clear_type == 'e') {
+        PyErr_Format(PyExc_TypeError, "cannot read shared exponent images");
+        return NULL;
+    }
 
-        PyObject * release = PyObject_CallMethod((PyObject *)src->image->ctx, "release", "(N)", temp);
-        if (!release) {
+    if (src->image->samples > 1) {
+        ImageFace * resolved = resolve_image_face(src, size, offset);
+        if (!resolved) {
             return NULL;
         }
-        Py_DECREF(release);
-        return res;
+        IntPair origin = {0, 0};
+        return read_image_face(resolved, size, origin, into);
     }
 
-    int write_size = size.x * size.y * src->image->fmt.pixel_size;
+    intptr write_size = (intptr)size.x * (intptr)size.y * (intptr)src->image->fmt.pixel_size;
 
     bind_read_framebuffer(src->ctx, src->framebuffer->obj);
 
     if (into == Py_None) {
         PyObject * res = PyBytes_FromStringAndSize(NULL, write_size);
-        glReadPixels(offset.x, offset.y, size.x, size.y, src->image->fmt.format, src->image->fmt.type, PyBytes_AsString(res));
+        read_pixels(src, size, offset, PyBytes_AsString(res));
         return res;
     }
 
@@ -1556,29 +2948,130 @@ static PyObject * read_image_face(ImageFace * src, IntPair size, IntPair offset,
             return NULL;
         }
 
-        char * ptr = (char *)(intptr)buffer_view->offset;
+        char * ptr = (char *)buffer_view->offset;
         glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer_view->buffer->buffer);
-        glReadPixels(offset.x, offset.y, size.x, size.y, src->image->fmt.format, src->image->fmt.type, ptr);
+        read_pixels(src, size, offset, ptr);
         glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
         Py_DECREF(buffer_view);
         Py_RETURN_NONE;
     }
 
     Py_buffer view;
+    intptr row_stride, layer_stride;
+    if (get_strided_pixels(src->image, into, size, 1, 1, &view, &row_stride, &layer_stride)) {
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ROW_LENGTH, (int)(row_stride / src->image->fmt.pixel_size));
+        read_pixels(src, size, offset, view.buf);
+        glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        PyBuffer_Release(&view);
+        Py_RETURN_NONE;
+    }
+
     if (PyObject_GetBuffer(into, &view, PyBUF_WRITABLE)) {
         return NULL;
     }
 
-    if (write_size > (int)view.len) {
+    if (write_size > view.len) {
+        PyBuffer_Release(&view);
         PyErr_Format(PyExc_ValueError, "invalid write size");
         return NULL;
     }
 
-    glReadPixels(offset.x, offset.y, size.x, size.y, src->image->fmt.format, src->image->fmt.type, view.buf);
+    read_pixels(src, size, offset, view.buf);
     PyBuffer_Release(&view);
     Py_RETURN_NONE;
 }
 
+static ReadbackBuffer acquire_readback_buffer(Context * self, intptr size) {
+    for (int i = 0; i < self->readback_buffer_count; ++i) {
+        if (self->readback_buffers[i].size >= size) {
+            ReadbackBuffer res = self->readback_buffers[i];
+            self->readback_buffer_count -= 1;
+            self->readback_buffers[i] = self->readback_buffers[self->readback_buffer_count];
+            return res;
+        }
+    }
+    ReadbackBuffer res = {0, size};
+    glGenBuffers(1, &res.buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, res.buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return res;
+}
+
+static void release_readback_buffer(Context * self, ReadbackBuffer buffer) {
+    if (self->readback_buffer_count < MAX_READBACK_BUFFERS) {
+        self->readback_buffers[self->readback_buffer_count++] = buffer;
+    } else {
+        glDeleteBuffers(1, &buffer.buffer);
+    }
+}
+
+static void defer_readback(Context * self, void * fence, ReadbackBuffer buffer) {
+    if (self->pending_readback_count == self->pending_readback_capacity) {
+        int capacity = self->pending_readback_capacity ? self->pending_readback_capacity * 2 : 16;
+        PendingReadback * pending = (PendingReadback *)PyMem_Realloc(self->pending_readbacks, (size_t)capacity * sizeof(PendingReadback));
+        if (!pending) {
+            return;
+        }
+        self->pending_readbacks = pending;
+        self->pending_readback_capacity = capacity;
+    }
+    self->pending_readbacks[self->pending_readback_count].fence = fence;
+    self->pending_readbacks[self->pending_readback_count].buffer = buffer;
+    self->pending_readback_count += 1;
+}
+
+static void release_pending_readbacks(Context * self) {
+    for (int i = 0; i < self->pending_readback_count; ++i) {
+        glDeleteSync(self->pending_readbacks[i].fence);
+        release_readback_buffer(self, self->pending_readbacks[i].buffer);
+    }
+    self->pending_readback_count = 0;
+}
+
+static Readback * read_image_faces_async(Image * image, PyObject * faces, IntPair size, IntPair offset) {
+    if (image->fmt.compressed) {
+        PyErr_Format(PyExc_TypeError, "cannot read compressed images");
+        return NULL;
+    }
+
+    if (image->fmt.clear_type == 'e') {
+        PyErr_Format(PyExc_TypeError, "cannot read shared exponent images");
+        return NULL;
+    }
+
+    if (image->samples > 1) {
+        ImageFace * resolved = resolve_image_face((ImageFace *)PyTuple_GetItem(faces, 0), size, offset);
+        if (!resolved) {
+            return NULL;
+        }
+        IntPair origin = {0, 0};
+        return read_image_faces_async(resolved->image, resolved->image->layers, size, origin);
+    }
+
+    Context * ctx = image->ctx;
+    intptr write_size = (intptr)size.x * (intptr)size.y * (intptr)image->fmt.pixel_size;
+    int face_count = (int)PyTuple_Size(faces);
+
+    ReadbackBuffer buffer = acquire_readback_buffer(ctx, write_size * face_count);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.buffer);
+    for (int i = 0; i < face_count; ++i) {
+        ImageFace * src = (ImageFace *)PyTuple_GetItem(faces, i);
+        bind_read_framebuffer(ctx, src->framebuffer->obj);
+        glReadPixels(offset.x, offset.y, size.x, size.y, image->fmt.format, image->fmt.type, (void *)(write_size * i));
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    Readback * res = PyObject_New(Readback, ctx->module_state->Readback_type);
+    res->ctx = (Context *)new_ref(ctx);
+    res->buffer = buffer;
+    res->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    res->size = write_size * face_count;
+    return res;
+}
+
 static int initialized;
 
 static PyObject * meth_init(PyObject * self, PyObject * args, PyObject * kwargs) {
@@ -1613,10 +3106,43 @@ static PyObject * meth_init(PyObject * self, PyObject * args, PyObject * kwargs)
     Py_RETURN_NONE;
 }
 
-static int get_limit(int pname, int min, int max) {
-    int value = 0;
-    glGetIntegerv(pname, &value);
-    if (value < 0) {
+#ifndef EXTERN_GL
+
+static PyObject * meth_null_loader(PyObject * self, PyObject * args, PyObject * kwargs) {
+    static char * keywords[] = {"interface", NULL};
+
+    PyObject * interface = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", keywords, &interface)) {
+        return NULL;
+    }
+
+    ModuleState * module_state = (ModuleState *)PyModule_GetState(self);
+
+    PyObject * symbols = PyDict_New();
+    for (int i = 0; i < NULL_GL_COUNT; ++i) {
+        PyObject * address = PyLong_FromVoidPtr(null_gl_functions[i]);
+        PyDict_SetItemString(symbols, null_gl_names[i], address);
+        Py_DECREF(address);
+    }
+
+    PyObject * calls = PyMemoryView_FromMemory((char *)null_gl_calls, sizeof(null_gl_calls), PyBUF_WRITE);
+    PyObject * loader = PyObject_CallMethod(module_state->helper, "NullLoader", "(NNO)", symbols, calls, interface);
+    if (!loader) {
+        return NULL;
+    }
+
+    Py_XDECREF(null_gl_loader);
+    null_gl_loader = new_ref(loader);
+    return loader;
+}
+
+#endif
+
+static int get_limit(int pname, int min, int max) {
+    int value = 0;
+    glGetIntegerv(pname, &value);
+    if (value < 0) {
         value = 0x7fffffff;
     }
     if (value < min) {
@@ -1645,6 +3171,8 @@ static Context * meth_context(PyObject * self, PyObject * args) {
     default_framebuffer->obj = 0;
     default_framebuffer->uses = 1;
     default_framebuffer->extra = NULL;
+    default_framebuffer->key = new_ref(Py_None);
+    default_framebuffer->shadow = NULL;
 
     Context * res = PyObject_New(Context, module_state->Context_type);
     res->gc_prev = (GCHeader *)res;
@@ -1662,7 +3190,11 @@ static Context * meth_context(PyObject * self, PyObject * args) {
     res->before_frame_callback = new_ref(Py_None);
     res->after_frame_callback = new_ref(Py_None);
     res->info_dict = NULL;
+    res->compressed_formats = NULL;
+    res->extension_formats = NULL;
+    res->program_binary_cache = new_ref(Py_None);
     res->current_descriptor_set = NULL;
+    reset_descriptor_slots(res);
     res->current_global_settings = NULL;
     res->is_mask_default = 0;
     res->is_stencil_default = 0;
@@ -1673,19 +3205,47 @@ static Context * meth_context(PyObject * self, PyObject * args) {
     res->current_viewport.height = -1;
     res->current_read_framebuffer = 0;
     res->current_draw_framebuffer = 0;
+    res->current_framebuffer_srgb = 0;
     res->current_program = 0;
     res->current_vertex_array = 0;
+    res->global_state_known = 0;
     res->current_depth_mask = 0;
-    res->current_stencil_mask = 0;
-    res->frame_time_query = 0;
+    zeromem(&res->current_stencil_front, sizeof(StencilSettings));
+    zeromem(&res->current_stencil_back, sizeof(StencilSettings));
+    zeromem(res->frame_time_queries, sizeof(res->frame_time_queries));
+    res->frame_time_head = 0;
+    res->frame_time_pending = 0;
     res->frame_time_query_running = 0;
     res->frame_time = 0;
+    res->frame_time_latency = 0;
+    res->frame_index = 0;
+    res->profile_events = NULL;
+    res->profile_queries = NULL;
+    res->profile_event_count = 0;
+    res->profile_event_capacity = 0;
+    res->profile_query_count = 0;
+    res->profile_running = 0;
+    res->profile_results = PyList_New(0);
+    res->flushing = 0;
+    res->skipped_uniform_calls = 0;
     res->default_texture_unit = 0;
     res->is_gles = 0;
     res->is_webgl = 0;
+    res->program_binary_support = 0;
+    res->readback_buffer_count = 0;
+    res->pending_readbacks = NULL;
+    res->pending_readback_count = 0;
+    res->pending_readback_capacity = 0;
+    res->indirect_draw_support = 0;
+    res->multi_draw_indirect_support = 0;
+    res->base_vertex_support = 0;
+    res->base_instance_support = 0;
+    res->timestamp_query_support = 0;
+    res->persistent_mapping_support = 0;
 
     res->limits.max_uniform_buffer_bindings = get_limit(GL_MAX_UNIFORM_BUFFER_BINDINGS, 8, MAX_BUFFER_BINDINGS);
     res->limits.max_uniform_block_size = get_limit(GL_MAX_UNIFORM_BLOCK_SIZE, 0x4000, 0x40000000);
+    res->limits.uniform_buffer_offset_alignment = get_limit(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, 1, 0x1000);
     res->limits.max_combined_uniform_blocks = get_limit(GL_MAX_COMBINED_UNIFORM_BLOCKS, 8, MAX_BUFFER_BINDINGS);
     res->limits.max_combined_texture_image_units = get_limit(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, 8, MAX_SAMPLER_BINDINGS);
     res->limits.max_vertex_attribs = get_limit(GL_MAX_VERTEX_ATTRIBS, 8, 64);
@@ -1697,20 +3257,58 @@ static Context * meth_context(PyObject * self, PyObject * args) {
     res->is_gles = startswith(version, "OpenGL ES");
     res->is_webgl = startswith(version, "WebGL");
 
+    if (program_binary_functions && !res->is_webgl) {
+        int num_program_binary_formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_program_binary_formats);
+        res->program_binary_support = num_program_binary_formats > 0;
+    }
+
+    res->indirect_draw_support = indirect_draw_functions && !res->is_webgl && (res->is_gles ? !startswith(version, "OpenGL ES 3.0") : version_at_least(version, '4', '0'));
+    res->multi_draw_indirect_support = res->indirect_draw_support && multi_draw_indirect_functions && !res->is_gles && version_at_least(version, '4', '3');
+    res->base_vertex_support = base_vertex_functions && !res->is_webgl && !startswith(version, "OpenGL ES 3.0") && !startswith(version, "OpenGL ES 3.1");
+    res->base_instance_support = base_instance_functions && !res->is_gles && !res->is_webgl && version_at_least(version, '4', '2');
+    res->timestamp_query_support = timestamp_query_functions && !res->is_gles && !res->is_webgl;
+    res->persistent_mapping_support = buffer_storage_functions && !res->is_gles && !res->is_webgl && version_at_least(version, '4', '4');
+
+    int num_extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+    PyObject * extensions = PyList_New(num_extensions);
+    for (int i = 0; i < num_extensions; ++i) {
+        const char * extension = glGetStringi(GL_EXTENSIONS, i);
+        PyList_SetItem(extensions, i, PyUnicode_FromString(extension ? extension : ""));
+    }
+
+    PyObject * compressed_formats = PyObject_CallMethod(module_state->helper, "compressed_formats", "(Oi)", extensions, res->is_gles);
+    if (!compressed_formats) {
+        Py_DECREF(extensions);
+        return NULL;
+    }
+
+    PyObject * extension_formats = PyObject_CallMethod(module_state->helper, "extension_formats", "(Ni)", extensions, res->is_gles || res->is_webgl);
+    if (!extension_formats) {
+        Py_DECREF(compressed_formats);
+        return NULL;
+    }
+
     res->info_dict = Py_BuildValue(
-        "{szszszszsisisisisisisi}",
+        "{szszszszsisisisisisisisisOsO}",
         "vendor", glGetString(GL_VENDOR),
         "renderer", glGetString(GL_RENDERER),
         "version", version,
         "glsl", glGetString(GL_SHADING_LANGUAGE_VERSION),
         "max_uniform_buffer_bindings", res->limits.max_uniform_buffer_bindings,
         "max_uniform_block_size", res->limits.max_uniform_block_size,
+        "uniform_buffer_offset_alignment", res->limits.uniform_buffer_offset_alignment,
         "max_combined_uniform_blocks", res->limits.max_combined_uniform_blocks,
         "max_combined_texture_image_units", res->limits.max_combined_texture_image_units,
         "max_vertex_attribs", res->limits.max_vertex_attribs,
         "max_draw_buffers", res->limits.max_draw_buffers,
-        "max_samples", res->limits.max_samples
+        "max_samples", res->limits.max_samples,
+        "compressed_formats", compressed_formats,
+        "extension_formats", extension_formats
     );
+    res->compressed_formats = compressed_formats;
+    res->extension_formats = extension_formats;
 
     int max_texture_image_units = get_limit(GL_MAX_TEXTURE_IMAGE_UNITS, 8, MAX_SAMPLER_BINDINGS + 1);
     res->default_texture_unit = GL_TEXTURE0 + max_texture_image_units - 1;
@@ -1729,17 +3327,35 @@ static Context * meth_context(PyObject * self, PyObject * args) {
     return res;
 }
 
+static int check_context_idle(Context * self) {
+    if (self->flushing) {
+        PyErr_Format(PyExc_RuntimeError, "the context is busy flushing a draw queue");
+        return 0;
+    }
+    return 1;
+}
+
 static Buffer * Context_meth_buffer(Context * self, PyObject * args, PyObject * kwargs) {
-    static char * keywords[] = {"data", "size", "access", "index", "uniform", "external", NULL};
+    if (!check_context_idle(self)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"data", "size", "access", "index", "uniform", "indirect", "external", NULL};
 
     PyObject * data = Py_None;
     PyObject * size_arg = Py_None;
     PyObject * access_arg = Py_None;
     int index = 0;
     int uniform = 0;
+    int indirect = 0;
     int external = 0;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O$OOppi", keywords, &data, &size_arg, &access_arg, &index, &uniform, &external)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O$OOpppi", keywords, &data, &size_arg, &access_arg, &index, &uniform, &indirect, &external)) {
+        return NULL;
+    }
+
+    if (indirect && !self->indirect_draw_support) {
+        PyErr_Format(PyExc_RuntimeError, "indirect draw is not supported");
         return NULL;
     }
 
@@ -1758,16 +3374,16 @@ static Buffer * Context_meth_buffer(Context * self, PyObject * args, PyObject *
         return NULL;
     }
 
-    int size = 0;
+    intptr size = 0;
     if (size_arg != Py_None) {
-        size = to_int(size_arg);
+        size = to_intptr(size_arg);
         if (size <= 0) {
             PyErr_Format(PyExc_ValueError, "invalid size");
             return NULL;
         }
     }
 
-    int target = uniform ? GL_UNIFORM_BUFFER : index ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+    int target = uniform ? GL_UNIFORM_BUFFER : index ? GL_ELEMENT_ARRAY_BUFFER : indirect ? GL_DRAW_INDIRECT_BUFFER : GL_ARRAY_BUFFER;
 
     if (data != Py_None) {
         data = PyMemoryView_GetContiguous(data, PyBUF_READ, 'C');
@@ -1778,7 +3394,7 @@ static Buffer * Context_meth_buffer(Context * self, PyObject * args, PyObject *
         if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE)) {
             return NULL;
         }
-        size = (int)view.len;
+        size = view.len;
         PyBuffer_Release(&view);
         if (size == 0) {
             PyErr_Format(PyExc_ValueError, "invalid size");
@@ -1796,9 +3412,18 @@ static Buffer * Context_meth_buffer(Context * self, PyObject * args, PyObject *
         return NULL;
     }
 
+    int stream = !PyUnicode_CompareWithASCIIString(access_arg, "stream_persistent");
+
     int buffer = 0;
+    char * mapped = NULL;
     if (external) {
         buffer = external;
+    } else if (stream && self->persistent_mapping_support) {
+        const int flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(target, buffer);
+        glBufferStorage(target, size, NULL, flags | GL_DYNAMIC_STORAGE_BIT);
+        mapped = (char *)glMapBufferRange(target, 0, size, flags);
     } else {
         glGenBuffers(1, &buffer);
         glBindBuffer(target, buffer);
@@ -1817,6 +3442,15 @@ static Buffer * Context_meth_buffer(Context * self, PyObject * args, PyObject *
     res->target = target;
     res->size = size;
     res->access = access;
+    res->stream = stream;
+    res->persistent = mapped != NULL;
+    res->mapped = mapped;
+    res->mapped_exports = 0;
+    res->stream_fence_count = 0;
+    res->stream_head = 0;
+    res->stream_used = 0;
+    res->stream_frame = -1;
+    res->stream_frame_used = 0;
 
     if (data != Py_None) {
         Py_XDECREF(PyObject_CallMethod((PyObject *)res, "write", "(N)", data));
@@ -1829,6 +3463,10 @@ static Buffer * Context_meth_buffer(Context * self, PyObject * args, PyObject *
 }
 
 static Image * Context_meth_image(Context * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self)) {
+        return NULL;
+    }
+
     static char * keywords[] = {"size", "format", "data", "samples", "array", "levels", "texture", "cubemap", "external", NULL};
 
     int width;
@@ -1923,6 +3561,34 @@ static Image * Context_meth_image(Context * self, PyObject * args, PyObject * kw
         return NULL;
     }
 
+    PyObject * required_extensions = PyObject_GetAttrString(self->module_state->helper, "EXTENSION_FORMATS");
+    int extension_format = PyDict_GetItem(required_extensions, format) != NULL;
+    Py_DECREF(required_extensions);
+
+    int supported = 1;
+    if (fmt.compressed) {
+        supported = PySequence_Contains(self->compressed_formats, format);
+    } else if (extension_format) {
+        supported = PySequence_Contains(self->extension_formats, format);
+    }
+    if (supported < 0) {
+        return NULL;
+    }
+    if (!supported) {
+        PyErr_Format(PyExc_ValueError, "the image format is not supported");
+        return NULL;
+    }
+
+    if (fmt.compressed && renderbuffer) {
+        PyErr_Format(PyExc_TypeError, "compressed images must be textures");
+        return NULL;
+    }
+
+    if (fmt.clear_type == 'e' && renderbuffer) {
+        PyErr_Format(PyExc_TypeError, "shared exponent images must be textures");
+        return NULL;
+    }
+
     int image = 0;
     if (external) {
         image = external;
@@ -1932,14 +3598,25 @@ static Image * Context_meth_image(Context * self, PyObject * args, PyObject * kw
         glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples > 1 ? samples : 0, fmt.internal_format, width, height);
     } else {
         glGenTextures(1, &image);
-        glActiveTexture(self->default_texture_unit);
-        glBindTexture(target, image);
+        bind_default_texture(self, target, image);
         glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         for (int level = 0; level < levels; ++level) {
             int w = least_one(width >> level);
             int h = least_one(height >> level);
-            if (cubemap) {
+            if (fmt.compressed) {
+                int size = (w + fmt.block_width - 1) / fmt.block_width * ((h + fmt.block_height - 1) / fmt.block_height) * fmt.pixel_size;
+                if (cubemap) {
+                    for (int i = 0; i < 6; ++i) {
+                        int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
+                        glCompressedTexImage2D(face, level, fmt.internal_format, w, h, 0, size, NULL);
+                    }
+                } else if (array) {
+                    glCompressedTexImage3D(target, level, fmt.internal_format, w, h, array, 0, size * array, NULL);
+                } else {
+                    glCompressedTexImage2D(target, level, fmt.internal_format, w, h, 0, size, NULL);
+                }
+            } else if (cubemap) {
                 for (int i = 0; i < 6; ++i) {
                     int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
                     glTexImage2D(face, level, fmt.internal_format, w, h, 0, fmt.format, fmt.type, NULL);
@@ -1963,6 +3640,7 @@ static Image * Context_meth_image(Context * self, PyObject * args, PyObject * kw
     res->size = Py_BuildValue("(ii)", width, height);
     res->format = new_ref(format);
     res->faces = PyDict_New();
+    res->resolve_target = NULL;
     res->fmt = fmt;
     res->clear_value.clear_ints[0] = 0;
     res->clear_value.clear_ints[1] = 0;
@@ -2001,6 +3679,10 @@ static Image * Context_meth_image(Context * self, PyObject * args, PyObject * kw
 }
 
 static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self)) {
+        return NULL;
+    }
+
     if (PyTuple_Size(args) || !kwargs) {
         PyErr_Format(PyExc_TypeError, "pipeline only takes keyword-only arguments");
         return NULL;
@@ -2024,11 +3706,15 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
         "vertex_count",
         "instance_count",
         "first_vertex",
+        "base_vertex",
+        "base_instance",
         "viewport",
         "uniform_data",
         "viewport_data",
         "render_data",
         "includes",
+        "indirect_buffer",
+        "indirect_count",
         NULL,
     };
 
@@ -2049,11 +3735,15 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
     int vertex_count = 0;
     int instance_count = 1;
     int first_vertex = 0;
+    int base_vertex = 0;
+    int base_instance = 0;
     PyObject * viewport = Py_None;
     PyObject * uniform_data = Py_None;
     PyObject * viewport_data = Py_None;
     PyObject * render_data = Py_None;
     PyObject * includes = Py_None;
+    PyObject * indirect_buffer = Py_None;
+    int indirect_count = 1;
 
     Pipeline * template = (Pipeline *)PyDict_GetItemString(kwargs, "template");
     PyObject * create_kwargs;
@@ -2082,7 +3772,7 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
     int args_ok = PyArg_ParseTupleAndKeywords(
         args,
         create_kwargs,
-        "|$O!O!OOOOOOOOOpOOiiiOOOOO",
+        "|$O!O!OOOOOOOOOpOOiiiiiOOOOOOi",
         keywords,
         &PyUnicode_Type,
         &vertex_shader,
@@ -2103,11 +3793,15 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
         &vertex_count,
         &instance_count,
         &first_vertex,
+        &base_vertex,
+        &base_instance,
         &viewport,
         &uniform_data,
         &viewport_data,
         &render_data,
-        &includes
+        &includes,
+        &indirect_buffer,
+        &indirect_count
     );
 
     if (!args_ok) {
@@ -2148,8 +3842,18 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
         return NULL;
     }
 
-    if (render_data != Py_None && !valid_mem(render_data, 12)) {
-        PyErr_Format(PyExc_TypeError, "render_data must be a contiguous memoryview with a size of 12 bytes");
+    if (render_data != Py_None && !valid_mem(render_data, 12) && !valid_mem(render_data, 20)) {
+        PyErr_Format(PyExc_TypeError, "render_data must be a contiguous memoryview with a size of 12 or 20 bytes");
+        return NULL;
+    }
+
+    if (base_vertex && !self->base_vertex_support) {
+        PyErr_Format(PyExc_ValueError, "base_vertex is not supported");
+        return NULL;
+    }
+
+    if (base_instance && !self->base_instance_support) {
+        PyErr_Format(PyExc_ValueError, "base_instance is not supported");
         return NULL;
     }
 
@@ -2159,6 +3863,53 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
         return NULL;
     }
 
+    Buffer * indirect = NULL;
+    intptr indirect_offset = 0;
+    intptr indirect_size = 0;
+
+    if (Py_TYPE(indirect_buffer) == self->module_state->Buffer_type) {
+        indirect = (Buffer *)indirect_buffer;
+        indirect_size = indirect->size;
+    } else if (Py_TYPE(indirect_buffer) == self->module_state->BufferView_type) {
+        indirect = ((BufferView *)indirect_buffer)->buffer;
+        indirect_offset = ((BufferView *)indirect_buffer)->offset;
+        indirect_size = ((BufferView *)indirect_buffer)->size;
+    } else if (indirect_buffer != Py_None) {
+        PyErr_Format(PyExc_TypeError, "indirect_buffer must be a Buffer or a BufferView");
+        return NULL;
+    }
+
+    if (indirect && !self->indirect_draw_support) {
+        PyErr_Format(PyExc_RuntimeError, "indirect draw is not supported");
+        return NULL;
+    }
+
+    intptr index_offset = 0;
+    if (Py_TYPE(index_buffer) == self->module_state->BufferView_type) {
+        index_offset = ((BufferView *)index_buffer)->offset;
+        index_buffer = (PyObject *)((BufferView *)index_buffer)->buffer;
+    }
+
+    if (index_offset % (short_index ? 2 : 4)) {
+        PyErr_Format(PyExc_ValueError, "the index_buffer offset must be a multiple of the index size");
+        return NULL;
+    }
+
+    if (indirect && index_offset) {
+        PyErr_Format(PyExc_ValueError, "cannot use an index_buffer offset with an indirect_buffer");
+        return NULL;
+    }
+
+    if (indirect_offset % 4) {
+        PyErr_Format(PyExc_ValueError, "the indirect_buffer offset must be a multiple of 4");
+        return NULL;
+    }
+
+    if (indirect && (indirect_count < 0 || (intptr)indirect_count * (index_buffer != Py_None ? 20 : 16) > indirect_size)) {
+        PyErr_Format(PyExc_ValueError, "the indirect_buffer is too small for %d draws", indirect_count);
+        return NULL;
+    }
+
     int topology;
     if (!get_topology(self->module_state->helper, topology_arg, &topology)) {
         PyErr_Format(PyExc_ValueError, "invalid topology");
@@ -2242,8 +3993,9 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
     }
 
     GLObject * framebuffer = build_framebuffer(self, framebuffer_attachments);
+    const int srgb = is_srgb_attachment(framebuffer_attachments);
 
-    PyObject * vertex_array_bindings = PyObject_CallMethod(self->module_state->helper, "vertex_array_bindings", "(OO)", vertex_buffers, index_buffer);
+    PyObject * vertex_array_bindings = PyObject_CallMethod(self->module_state->helper, "vertex_array_bindings", "(OOO)", vertex_buffers, index_buffer, self->module_state->BufferView_type);
     if (!vertex_array_bindings) {
         return NULL;
     }
@@ -2311,6 +4063,11 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
     if (uniforms) {
         PyObject_GetBuffer(uniform_layout, &res->uniform_layout_buffer, PyBUF_SIMPLE);
         PyObject_GetBuffer(uniform_data, &res->uniform_data_buffer, PyBUF_SIMPLE);
+        if (!program->shadow) {
+            const UniformHeader * const header = (UniformHeader *)res->uniform_layout_buffer.buf;
+            program->shadow = (char *)PyMem_Malloc(header->shadow_size ? (size_t)header->shadow_size : 1);
+            zeromem(program->shadow, header->shadow_size);
+        }
     }
 
     PyObject_GetBuffer(viewport_data, &res->viewport_data_buffer, PyBUF_SIMPLE);
@@ -2331,21 +4088,142 @@ static Pipeline * Context_meth_pipeline(Context * self, PyObject * args, PyObjec
     res->params.vertex_count = vertex_count;
     res->params.instance_count = instance_count;
     res->params.first_vertex = first_vertex;
+    res->params.base_vertex = base_vertex;
+    res->params.base_instance = base_instance;
+    res->base_draws = res->render_data_buffer.len == (Py_ssize_t)sizeof(RenderParameters) && (self->base_vertex_support || self->base_instance_support);
     res->index_type = index_type;
     res->index_size = index_size;
+    res->index_offset = index_offset;
+    res->srgb = srgb;
+    res->indirect_buffer = indirect ? (Buffer *)new_ref(indirect) : NULL;
+    res->label = new_ref(Py_None);
+    res->dynamic_offset = 0;
+    res->indirect_offset = indirect_offset;
+    res->indirect_size = indirect_size;
+    res->indirect_count = indirect_count;
     res->descriptor_set = descriptor_set;
     res->global_settings = global_settings;
     return res;
 }
 
+static int collect_frame_time(Context * self, int wait) {
+    int collected = 0;
+    while (self->frame_time_pending) {
+        int index = (self->frame_time_head - self->frame_time_pending + FRAME_TIME_QUERIES) % FRAME_TIME_QUERIES;
+        FrameTimeQuery * query = &self->frame_time_queries[index];
+        if (!wait) {
+            int available = 0;
+            glGetQueryObjectuiv(query->query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                break;
+            }
+        }
+        glGetQueryObjectuiv(query->query, GL_QUERY_RESULT, &self->frame_time);
+        self->frame_time_latency = self->frame_index - query->frame;
+        self->frame_time_pending -= 1;
+        collected = 1;
+        wait = 0;
+    }
+    return collected;
+}
+
+static void release_profile_query(Context * self, int query) {
+    self->profile_queries[self->profile_query_count++] = query;
+}
+
+static void delete_queries(Context * self, int all) {
+    if (self->profile_query_count) {
+        glDeleteQueries(self->profile_query_count, self->profile_queries);
+        self->profile_query_count = 0;
+    }
+    if (all || !self->profile_running) {
+        for (int i = 0; i < self->profile_event_count; ++i) {
+            ProfileEvent * event = &self->profile_events[i];
+            glDeleteQueries(1, &event->begin_query);
+            glDeleteQueries(1, &event->end_query);
+            Py_XDECREF(event->label);
+        }
+        self->profile_event_count = 0;
+    }
+    if (all || !self->frame_time_query_running) {
+        for (int i = 0; i < FRAME_TIME_QUERIES; ++i) {
+            if (self->frame_time_queries[i].query) {
+                glDeleteQueries(1, &self->frame_time_queries[i].query);
+                self->frame_time_queries[i].query = 0;
+            }
+        }
+        self->frame_time_head = 0;
+        self->frame_time_pending = 0;
+    }
+}
+
+static int collect_profile_events(Context * self) {
+    int collected = 0;
+    int failed = 0;
+    while (collected < self->profile_event_count) {
+        ProfileEvent * event = &self->profile_events[collected];
+        int available = 0;
+        glGetQueryObjectuiv(event->end_query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        unsigned long long begin = 0;
+        unsigned long long end = 0;
+        glGetQueryObjectui64v(event->begin_query, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(event->end_query, GL_QUERY_RESULT, &end);
+        release_profile_query(self, event->begin_query);
+        release_profile_query(self, event->end_query);
+        collected += 1;
+        if (failed) {
+            Py_XDECREF(event->label);
+            continue;
+        }
+        PyObject * name = event->label ? PyObject_Str(event->label) : PyUnicode_FromString(event->name);
+        PyObject * item = name ? Py_BuildValue(
+            "{sNssssslslsdsds{si}}",
+            "name", name,
+            "cat", event->name,
+            "ph", "X",
+            "pid", 0L,
+            "tid", 0L,
+            "ts", (double)begin / 1000.0,
+            "dur", (double)(end - begin) / 1000.0,
+            "args", "frame", event->frame
+        ) : NULL;
+        Py_XDECREF(event->label);
+        if (!item || PyList_Append(self->profile_results, item)) {
+            failed = 1;
+        }
+        Py_XDECREF(item);
+    }
+    self->profile_event_count -= collected;
+    for (int i = 0; i < self->profile_event_count; ++i) {
+        self->profile_events[i] = self->profile_events[i + collected];
+    }
+    return failed ? -1 : 0;
+}
+
 static PyObject * Context_meth_new_frame(Context * self, PyObject * args, PyObject * kwargs) {
-    static char * keywords[] = {"reset", "clear", "frame_time", NULL};
+    static char * keywords[] = {"reset", "clear", "frame_time", "profile", NULL};
 
     int reset = 0;
     int clear = 1;
     int frame_time = 0;
+    int profile = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|pppp", keywords, &reset, &clear, &frame_time, &profile)) {
+        return NULL;
+    }
+
+    if (self->flushing) {
+        PyErr_Format(PyExc_RuntimeError, "cannot start a frame while a draw queue is being flushed");
+        return NULL;
+    }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|ppp", keywords, &reset, &clear, &frame_time)) {
+    release_pending_readbacks(self);
+
+    if (profile && !self->timestamp_query_support) {
+        PyErr_Format(PyExc_RuntimeError, "timestamp queries are not supported");
         return NULL;
     }
 
@@ -2359,6 +4237,7 @@ static PyObject * Context_meth_new_frame(Context * self, PyObject * args, PyObje
 
     if (reset) {
         self->current_descriptor_set = NULL;
+        reset_descriptor_slots(self);
         self->current_global_settings = NULL;
         self->is_stencil_default = 0;
         self->is_mask_default = 0;
@@ -2369,26 +4248,37 @@ static PyObject * Context_meth_new_frame(Context * self, PyObject * args, PyObje
         self->current_viewport.height = -1;
         self->current_read_framebuffer = -1;
         self->current_draw_framebuffer = -1;
+        self->current_framebuffer_srgb = -1;
         self->current_program = -1;
         self->current_vertex_array = -1;
+        self->global_state_known = 0;
         self->current_depth_mask = 0;
-        self->current_stencil_mask = 0;
+        self->current_stencil_front.write_mask = 0;
     }
 
+    self->skipped_uniform_calls = 0;
+
     if (clear) {
         bind_draw_framebuffer(self, self->default_framebuffer->obj);
+        bind_framebuffer_srgb(self, 0);
         glClear(GL_COLOR_BUFFER_BIT);
     }
 
     if (frame_time) {
-        if (!self->frame_time_query) {
-            glGenQueries(1, &self->frame_time_query);
+        if (self->frame_time_pending == FRAME_TIME_QUERIES) {
+            collect_frame_time(self, 1);
         }
-        glBeginQuery(GL_TIME_ELAPSED, self->frame_time_query);
+        FrameTimeQuery * query = &self->frame_time_queries[self->frame_time_head];
+        if (!query->query) {
+            glGenQueries(1, &query->query);
+        }
+        glBeginQuery(GL_TIME_ELAPSED, query->query);
+        query->frame = self->frame_index;
         self->frame_time_query_running = 1;
-        self->frame_time = 0;
     }
 
+    self->profile_running = profile;
+
     if (!self->is_webgl) {
         glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
     }
@@ -2410,6 +4300,13 @@ static PyObject * Context_meth_end_frame(Context * self, PyObject * args, PyObje
         return NULL;
     }
 
+    if (self->flushing) {
+        PyErr_Format(PyExc_RuntimeError, "cannot end a frame while a draw queue is being flushed");
+        return NULL;
+    }
+
+    release_pending_readbacks(self);
+
     if (clean) {
         bind_draw_framebuffer(self, 0);
         bind_program(self, 0);
@@ -2417,6 +4314,8 @@ static PyObject * Context_meth_end_frame(Context * self, PyObject * args, PyObje
 
         self->current_descriptor_set = NULL;
         self->current_global_settings = NULL;
+        self->global_state_known = 0;
+        reset_descriptor_slots(self);
 
         glActiveTexture(GL_TEXTURE0);
 
@@ -2432,14 +4331,15 @@ static PyObject * Context_meth_end_frame(Context * self, PyObject * args, PyObje
             glDisable(GL_PROGRAM_POINT_SIZE);
             glDisable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
         }
+        bind_framebuffer_srgb(self, 0);
     }
 
-    if (self->frame_time_query_running) {
+    const int frame_time = self->frame_time_query_running;
+    if (frame_time) {
         glEndQuery(GL_TIME_ELAPSED);
-        glGetQueryObjectuiv(self->frame_time_query, GL_QUERY_RESULT, &self->frame_time);
+        self->frame_time_head = (self->frame_time_head + 1) % FRAME_TIME_QUERIES;
+        self->frame_time_pending += 1;
         self->frame_time_query_running = 0;
-    } else {
-        self->frame_time = 0;
     }
 
     if (flush) {
@@ -2448,10 +4348,23 @@ static PyObject * Context_meth_end_frame(Context * self, PyObject * args, PyObje
 
     if (sync) {
         void * fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        Py_BEGIN_ALLOW_THREADS
         glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, -1);
+        Py_END_ALLOW_THREADS
         glDeleteSync(fence);
     }
 
+    if (!collect_frame_time(self, 0) && !frame_time && !self->frame_time_pending) {
+        self->frame_time = 0;
+        self->frame_time_latency = 0;
+    }
+    self->frame_index += 1;
+
+    self->profile_running = 0;
+    if (self->profile_event_count && collect_profile_events(self)) {
+        return NULL;
+    }
+
     if (self->after_frame_callback != Py_None) {
         PyObject * temp = PyObject_CallObject(self->after_frame_callback, NULL);
         Py_XDECREF(temp);
@@ -2471,7 +4384,12 @@ static void release_descriptor_set(Context * self, DescriptorSet * set) {
             if (sampler) {
                 sampler->uses -= 1;
                 if (!sampler->uses) {
-                    remove_dict_value(self->sampler_cache, (PyObject *)sampler);
+                    PyDict_DelItem(self->sampler_cache, sampler->key);
+                    for (int j = 0; j < MAX_SAMPLER_BINDINGS; ++j) {
+                        if (self->current_samplers[j] == sampler->obj) {
+                            self->current_samplers[j] = -1;
+                        }
+                    }
                     glDeleteSamplers(1, &sampler->obj);
                 }
             }
@@ -2483,7 +4401,7 @@ static void release_descriptor_set(Context * self, DescriptorSet * set) {
             Py_XDECREF((PyObject *)set->samplers.binding[i].sampler);
             Py_XDECREF((PyObject *)set->samplers.binding[i].image);
         }
-        remove_dict_value(self->descriptor_set_cache, (PyObject *)set);
+        PyDict_DelItem(self->descriptor_set_cache, set->key);
         if (self->current_descriptor_set == set) {
             self->current_descriptor_set = NULL;
         }
@@ -2493,33 +4411,17 @@ static void release_descriptor_set(Context * self, DescriptorSet * set) {
 static void release_global_settings(Context * self, GlobalSettings * settings) {
     settings->uses -= 1;
     if (!settings->uses) {
-        remove_dict_value(self->global_settings_cache, (PyObject *)settings);
+        PyDict_DelItem(self->global_settings_cache, settings->key);
         if (self->current_global_settings == settings) {
             self->current_global_settings = NULL;
         }
     }
 }
 
-static void release_framebuffer(Context * self, GLObject * framebuffer) {
-    framebuffer->uses -= 1;
-    if (!framebuffer->uses) {
-        remove_dict_value(self->framebuffer_cache, (PyObject *)framebuffer);
-        if (framebuffer->obj) {
-            bind_draw_framebuffer(self, 0);
-            bind_read_framebuffer(self, 0);
-            glDeleteFramebuffers(1, &framebuffer->obj);
-        }
-        self->current_viewport.x = -1;
-        self->current_viewport.y = -1;
-        self->current_viewport.width = -1;
-        self->current_viewport.height = -1;
-    }
-}
-
 static void release_program(Context * self, GLObject * program) {
     program->uses -= 1;
     if (!program->uses) {
-        remove_dict_value(self->program_cache, (PyObject *)program);
+        PyDict_DelItem(self->program_cache, program->key);
         bind_program(self, 0);
         glDeleteProgram(program->obj);
     }
@@ -2528,38 +4430,57 @@ static void release_program(Context * self, GLObject * program) {
 static void release_vertex_array(Context * self, GLObject * vertex_array) {
     vertex_array->uses -= 1;
     if (!vertex_array->uses) {
-        remove_dict_value(self->vertex_array_cache, (PyObject *)vertex_array);
+        PyDict_DelItem(self->vertex_array_cache, vertex_array->key);
         bind_vertex_array(self, 0);
         glDeleteVertexArrays(1, &vertex_array->obj);
     }
 }
 
+static PyObject * Context_meth_profile(Context * self, PyObject * args) {
+    PyObject * res = self->profile_results;
+    self->profile_results = PyList_New(0);
+    return res;
+}
+
 static PyObject * Context_meth_release(Context * self, PyObject * arg) {
+    if (self->flushing) {
+        PyErr_Format(PyExc_RuntimeError, "cannot release objects while a draw queue is being flushed");
+        return NULL;
+    }
+
     if (Py_TYPE(arg) == self->module_state->Buffer_type) {
         Buffer * buffer = (Buffer *)arg;
+        if (buffer->mapped_exports) {
+            PyErr_Format(PyExc_BufferError, "cannot release a buffer while its mapping is in use");
+            return NULL;
+        }
         buffer->gc_prev->gc_next = buffer->gc_next;
         buffer->gc_next->gc_prev = buffer->gc_prev;
+        for (int i = 0; i < MAX_BUFFER_BINDINGS; ++i) {
+            if (self->current_uniform_buffers[i].buffer == buffer->buffer) {
+                self->current_uniform_buffers[i].buffer = -1;
+            }
+        }
+        for (int i = 0; i < buffer->stream_fence_count; ++i) {
+            glDeleteSync(buffer->stream_fences[i].fence);
+        }
+        if (buffer->mapped) {
+            glBindBuffer(buffer->target, buffer->buffer);
+            glUnmapBuffer(buffer->target);
+            glBindBuffer(buffer->target, 0);
+            buffer->mapped = NULL;
+        }
         glDeleteBuffers(1, &buffer->buffer);
         Py_DECREF(buffer);
     } else if (Py_TYPE(arg) == self->module_state->Image_type) {
         Image * image = (Image *)arg;
+        if (image->gc_next == (GCHeader *)image) {
+            PyErr_Format(PyExc_ValueError, "cannot release a resolve target");
+            return NULL;
+        }
         image->gc_prev->gc_next = image->gc_next;
         image->gc_next->gc_prev = image->gc_prev;
-        if (image->faces) {
-            PyObject * key = NULL;
-            PyObject * value = NULL;
-            Py_ssize_t pos = 0;
-            while (PyDict_Next(image->faces, &pos, &key, &value)) {
-                ImageFace * face = (ImageFace *)value;
-                release_framebuffer(self, face->framebuffer);
-            }
-            PyDict_Clear(image->faces);
-        }
-        if (image->renderbuffer) {
-            glDeleteRenderbuffers(1, &image->image);
-        } else {
-            glDeleteTextures(1, &image->image);
-        }
+        release_image(self, image);
         Py_DECREF(image);
     } else if (Py_TYPE(arg) == self->module_state->Pipeline_type) {
         Pipeline * pipeline = (Pipeline *)arg;
@@ -2588,6 +4509,14 @@ static PyObject * Context_meth_release(Context * self, PyObject * arg) {
         PyDict_Clear(self->shader_cache);
     } else if (PyUnicode_CheckExact(arg) && !PyUnicode_CompareWithASCIIString(arg, "all")) {
         GCHeader * it = self->gc_next;
+        while (it != (GCHeader *)self) {
+            if (Py_TYPE((PyObject *)it) == self->module_state->Buffer_type && ((Buffer *)it)->mapped_exports) {
+                PyErr_Format(PyExc_BufferError, "cannot release a buffer while its mapping is in use");
+                return NULL;
+            }
+            it = it->gc_next;
+        }
+        it = self->gc_next;
         while (it != (GCHeader *)self) {
             GCHeader * next = it->gc_next;
             if (Py_TYPE((PyObject *)it) == self->module_state->Pipeline_type) {
@@ -2605,10 +4534,101 @@ static PyObject * Context_meth_release(Context * self, PyObject * arg) {
             }
             it = next;
         }
+        release_pending_readbacks(self);
+        for (int i = 0; i < self->readback_buffer_count; ++i) {
+            glDeleteBuffers(1, &self->readback_buffers[i].buffer);
+        }
+        self->readback_buffer_count = 0;
+        delete_queries(self, 0);
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject * Context_meth_render(Context * self, PyObject * arg) {
+    if (!check_context_idle(self)) {
+        return NULL;
+    }
+
+    PyObject * pipelines = PySequence_Tuple(arg);
+    if (!pipelines) {
+        PyErr_Clear();
+        PyErr_Format(PyExc_TypeError, "pipelines must be a sequence of Pipeline objects");
+        return NULL;
+    }
+
+    Py_ssize_t count = PyTuple_Size(pipelines);
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        if (Py_TYPE(PyTuple_GetItem(pipelines, i)) != self->module_state->Pipeline_type) {
+            Py_DECREF(pipelines);
+            PyErr_Format(PyExc_TypeError, "pipelines must be a sequence of Pipeline objects");
+            return NULL;
+        }
+    }
+
+    for (Py_ssize_t i = 0; i < count; ++i) {
+        Pipeline * pipeline = (Pipeline *)PyTuple_GetItem(pipelines, i);
+        render_pipeline(pipeline);
     }
+
+    Py_DECREF(pipelines);
     Py_RETURN_NONE;
 }
 
+static DrawQueue * Context_meth_draw_queue(Context * self, PyObject * args, PyObject * kwargs) {
+    static char * keywords[] = {"sort", NULL};
+
+    int sort = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", keywords, &sort)) {
+        return NULL;
+    }
+
+    DrawQueue * res = PyObject_New(DrawQueue, self->module_state->DrawQueue_type);
+    res->ctx = (Context *)new_ref(self);
+    res->commands = NULL;
+    res->count = 0;
+    res->capacity = 0;
+    res->uniform_data = NULL;
+    res->uniform_size = 0;
+    res->uniform_capacity = 0;
+    res->sort = sort;
+    res->saved_binds = 0;
+    res->flushing = 0;
+    return res;
+}
+
+static BufferArena * Context_meth_buffer_arena(Context * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"size", "index", "access", NULL};
+
+    PyObject * size_arg;
+    int index = 0;
+    PyObject * access = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$pO", keywords, &size_arg, &index, &access)) {
+        return NULL;
+    }
+
+    PyObject * buffer_kwargs = Py_BuildValue("{sOsOsO}", "size", size_arg, "index", index ? Py_True : Py_False, "access", access);
+    Buffer * buffer = Context_meth_buffer(self, self->module_state->empty_tuple, buffer_kwargs);
+    Py_DECREF(buffer_kwargs);
+    if (!buffer) {
+        return NULL;
+    }
+
+    BufferArena * res = PyObject_New(BufferArena, self->module_state->BufferArena_type);
+    res->ctx = (Context *)new_ref(self);
+    res->buffer = buffer;
+    res->blocks = NULL;
+    res->count = 0;
+    res->capacity = 0;
+    res->used = 0;
+    return res;
+}
+
 static PyObject * Context_meth_gc(Context * self, PyObject * arg) {
     PyObject * res = PyList_New(0);
     GCHeader * it = self->gc_next;
@@ -2620,11 +4640,41 @@ static PyObject * Context_meth_gc(Context * self, PyObject * arg) {
     return res;
 }
 
+static PyObject * Context_get_program_binary_cache(Context * self, void * closure) {
+    return new_ref(self->program_binary_cache);
+}
+
+static int Context_set_program_binary_cache(Context * self, PyObject * value, void * closure) {
+    if (!value) {
+        PyErr_Format(PyExc_TypeError, "cannot delete the program_binary_cache, set it to None instead");
+        return -1;
+    }
+
+    PyObject * path = value != Py_None ? PyOS_FSPath(value) : new_ref(Py_None);
+    if (!path) {
+        return -1;
+    }
+
+    if (path != Py_None && !PyUnicode_Check(path)) {
+        Py_DECREF(path);
+        PyErr_Format(PyExc_TypeError, "the program_binary_cache must be a str path or None");
+        return -1;
+    }
+
+    Py_DECREF(self->program_binary_cache);
+    self->program_binary_cache = path;
+    return 0;
+}
+
 static PyObject * Context_get_screen(Context * self, void * closure) {
     return PyLong_FromLong(self->default_framebuffer->obj);
 }
 
 static int Context_set_screen(Context * self, PyObject * value, void * closure) {
+    if (!check_context_idle(self)) {
+        return -1;
+    }
+
     if (!PyLong_CheckExact(value)) {
         PyErr_Format(PyExc_TypeError, "the clear value must be an int");
         return -1;
@@ -2635,12 +4685,16 @@ static int Context_set_screen(Context * self, PyObject * value, void * closure)
 }
 
 static PyObject * Buffer_meth_write(Buffer * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
     static char * keywords[] = {"data", "offset", NULL};
 
     PyObject * data;
-    int offset = 0;
+    intptr offset = 0;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i", keywords, &data, &offset)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|n", keywords, &data, &offset)) {
         return NULL;
     }
 
@@ -2660,7 +4714,8 @@ static PyObject * Buffer_meth_write(Buffer * self, PyObject * args, PyObject * k
     }
 
     if (buffer_view) {
-        if (buffer_view->size + offset > self->size) {
+        if (buffer_view->size > self->size - offset) {
+            Py_DECREF(buffer_view);
             PyErr_Format(PyExc_ValueError, "invalid size");
             return NULL;
         }
@@ -2683,9 +4738,11 @@ static PyObject * Buffer_meth_write(Buffer * self, PyObject * args, PyObject * k
         return NULL;
     }
     char * ptr = (char *)view.buf;
-    int data_size = (int)view.len;
+    intptr data_size = view.len;
 
-    if (data_size + offset > self->size) {
+    if (data_size > self->size - offset) {
+        PyBuffer_Release(&view);
+        Py_DECREF(mem);
         PyErr_Format(PyExc_ValueError, "invalid size");
         return NULL;
     }
@@ -2700,7 +4757,7 @@ static PyObject * Buffer_meth_write(Buffer * self, PyObject * args, PyObject * k
         }
 
         glBindBuffer(self->target, self->buffer);
-        glBufferSubData(self->target, offset, data_size, ptr);
+        buffer_sub_data(self->target, offset, data_size, ptr);
         glBindBuffer(self->target, 0);
     }
 
@@ -2710,13 +4767,17 @@ static PyObject * Buffer_meth_write(Buffer * self, PyObject * args, PyObject * k
 }
 
 static PyObject * Buffer_meth_read(Buffer * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
     static char * keywords[] = {"size", "offset", "into", NULL};
 
     PyObject * size_arg = Py_None;
-    int offset = 0;
+    intptr offset = 0;
     PyObject * into = Py_None;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OiO", keywords, &size_arg, &offset, &into)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OnO", keywords, &size_arg, &offset, &into)) {
         return NULL;
     }
 
@@ -2730,16 +4791,16 @@ static PyObject * Buffer_meth_read(Buffer * self, PyObject * args, PyObject * kw
         return NULL;
     }
 
-    int size = self->size - offset;
+    intptr size = self->size - offset;
     if (size_arg != Py_None) {
-        size = to_int(size_arg);
+        size = to_intptr(size_arg);
         if (size < 0) {
             PyErr_Format(PyExc_ValueError, "invalid size");
             return NULL;
         }
     }
 
-    if (size < 0 || size + offset > self->size) {
+    if (size < 0 || size > self->size - offset) {
         PyErr_Format(PyExc_ValueError, "invalid size");
         return NULL;
     }
@@ -2756,12 +4817,18 @@ static PyObject * Buffer_meth_read(Buffer * self, PyObject * args, PyObject * kw
 
     if (into == Py_None) {
         PyObject * res = PyBytes_FromStringAndSize(NULL, size);
-        glGetBufferSubData(self->target, offset, size, PyBytes_AsString(res));
+        if (!res) {
+            return NULL;
+        }
+        char * ptr = PyBytes_AsString(res);
+        Py_BEGIN_ALLOW_THREADS
+        get_buffer_sub_data(self->target, offset, size, ptr);
+        Py_END_ALLOW_THREADS
         return res;
     }
 
     if (Py_TYPE(into) == self->ctx->module_state->Buffer_type) {
-        PyObject * chunk = PyObject_CallMethod((PyObject *)self, "view", "(ii)", size, offset);
+        PyObject * chunk = PyObject_CallMethod((PyObject *)self, "view", "(nn)", size, offset);
         return PyObject_CallMethod(into, "write", "(N)", chunk);
     }
 
@@ -2771,8 +4838,8 @@ static PyObject * Buffer_meth_read(Buffer * self, PyObject * args, PyObject * kw
             PyErr_Format(PyExc_ValueError, "invalid size");
             return NULL;
         }
-        PyObject * chunk = PyObject_CallMethod((PyObject *)self, "view", "(ii)", size, offset);
-        return PyObject_CallMethod((PyObject *)buffer_view->buffer, "write", "(Ni)", chunk, buffer_view->offset);
+        PyObject * chunk = PyObject_CallMethod((PyObject *)self, "view", "(nn)", size, offset);
+        return PyObject_CallMethod((PyObject *)buffer_view->buffer, "write", "(Nn)", chunk, buffer_view->offset);
     }
 
     Py_buffer view;
@@ -2780,12 +4847,15 @@ static PyObject * Buffer_meth_read(Buffer * self, PyObject * args, PyObject * kw
         return NULL;
     }
 
-    if (size > (int)view.len) {
+    if (size > view.len) {
+        PyBuffer_Release(&view);
         PyErr_Format(PyExc_ValueError, "invalid size");
         return NULL;
     }
 
-    glGetBufferSubData(self->target, offset, size, view.buf);
+    Py_BEGIN_ALLOW_THREADS
+    get_buffer_sub_data(self->target, offset, size, (char *)view.buf);
+    Py_END_ALLOW_THREADS
     PyBuffer_Release(&view);
     Py_RETURN_NONE;
 }
@@ -2794,15 +4864,15 @@ static BufferView * Buffer_meth_view(Buffer * self, PyObject * args, PyObject *
     static char * keywords[] = {"size", "offset", NULL};
 
     PyObject * size_arg = Py_None;
-    int offset = 0;
+    intptr offset = 0;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Oi", keywords, &size_arg, &offset)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|On", keywords, &size_arg, &offset)) {
         return NULL;
     }
 
-    int size = self->size - offset;
+    intptr size = self->size - offset;
     if (size_arg != Py_None) {
-        size = to_int(size_arg);
+        size = to_intptr(size_arg);
     }
 
     if (offset < 0 || offset > self->size) {
@@ -2810,7 +4880,7 @@ static BufferView * Buffer_meth_view(Buffer * self, PyObject * args, PyObject *
         return NULL;
     }
 
-    if (size < 0 || offset + size > self->size) {
+    if (size < 0 || size > self->size - offset) {
         PyErr_Format(PyExc_ValueError, "invalid size");
         return NULL;
     }
@@ -2822,394 +4892,1447 @@ static BufferView * Buffer_meth_view(Buffer * self, PyObject * args, PyObject *
     return res;
 }
 
-static PyObject * Image_meth_clear(Image * self, PyObject * args) {
-    const int count = (int)PyTuple_Size(self->layers);
-    for (int i = 0; i < count; ++i) {
-        ImageFace * face = (ImageFace *)PyTuple_GetItem(self->layers, i);
-        bind_draw_framebuffer(self->ctx, face->framebuffer->obj);
-        clear_bound_image(self);
+static PyObject * Buffer_meth_map(Buffer * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
     }
-    Py_RETURN_NONE;
+
+    if (!self->mapped) {
+        PyErr_Format(PyExc_RuntimeError, "the buffer is not persistently mapped");
+        return NULL;
+    }
+    BufferMapping * mapping = PyObject_New(BufferMapping, self->ctx->module_state->BufferMapping_type);
+    mapping->buffer = (Buffer *)new_ref(self);
+    PyObject * res = PyMemoryView_FromObject((PyObject *)mapping);
+    Py_DECREF(mapping);
+    return res;
 }
 
-static PyObject * Image_meth_write(Image * self, PyObject * args, PyObject * kwargs) {
-    static char * keywords[] = {"data", "size", "offset", "layer", "level", NULL};
+static int BufferMapping_getbuffer(BufferMapping * self, Py_buffer * view, int flags) {
+    if (!self->buffer->mapped) {
+        PyErr_Format(PyExc_BufferError, "the buffer was released");
+        return -1;
+    }
+    if (PyBuffer_FillInfo(view, (PyObject *)self, self->buffer->mapped, self->buffer->size, 0, flags)) {
+        return -1;
+    }
+    self->buffer->mapped_exports += 1;
+    return 0;
+}
 
-    PyObject * data;
+static void BufferMapping_releasebuffer(BufferMapping * self, Py_buffer * view) {
+    self->buffer->mapped_exports -= 1;
+}
+
+static void wait_stream_fence(Buffer * self) {
+    void * fence = self->stream_fences[0].fence;
+    Py_BEGIN_ALLOW_THREADS
+    glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, -1);
+    Py_END_ALLOW_THREADS
+    glDeleteSync(fence);
+    self->stream_used -= self->stream_fences[0].size;
+    self->stream_fence_count -= 1;
+    for (int i = 0; i < self->stream_fence_count; ++i) {
+        self->stream_fences[i] = self->stream_fences[i + 1];
+    }
+}
+
+static BufferView * Buffer_meth_stream(Buffer * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"data", "size", "align", NULL};
+
+    PyObject * data = Py_None;
     PyObject * size_arg = Py_None;
-    PyObject * offset_arg = Py_None;
-    PyObject * layer_arg = Py_None;
-    int level = 0;
+    PyObject * align_arg = Py_None;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OOOi", keywords, &data, &size_arg, &offset_arg, &layer_arg, &level)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O$OO", keywords, &data, &size_arg, &align_arg)) {
         return NULL;
     }
 
-    if (layer_arg != Py_None && !PyLong_CheckExact(layer_arg)) {
-        PyErr_Format(PyExc_TypeError, "the layer must be an int or None");
+    if (!self->stream) {
+        PyErr_Format(PyExc_TypeError, "the buffer was not created with access=\"stream_persistent\"");
         return NULL;
     }
 
-    int layer = 0;
-    if (layer_arg != Py_None) {
-        layer = to_int(layer_arg);
+    if (size_arg != Py_None && !PyLong_CheckExact(size_arg)) {
+        PyErr_Format(PyExc_TypeError, "the size must be an int");
+        return NULL;
     }
 
-    IntPair size = to_int_pair(size_arg, least_one(self->width >> level), least_one(self->height >> level));
-    if (PyErr_Occurred()) {
-        PyErr_Format(PyExc_TypeError, "the size must be a tuple of 2 ints");
+    if ((data == Py_None) == (size_arg == Py_None)) {
+        PyErr_Format(PyExc_ValueError, "either data or size is required");
         return NULL;
     }
 
-    IntPair offset = to_int_pair(offset_arg, 0, 0);
-    if (PyErr_Occurred()) {
-        PyErr_Format(PyExc_TypeError, "the offset must be a tuple of 2 ints");
+    if (align_arg != Py_None && !PyLong_CheckExact(align_arg)) {
+        PyErr_Format(PyExc_TypeError, "the align must be an int");
         return NULL;
     }
 
-    if (size_arg == Py_None && offset_arg != Py_None) {
-        PyErr_Format(PyExc_ValueError, "the size is required when the offset is not None");
+    int align = self->target == GL_UNIFORM_BUFFER ? self->ctx->limits.uniform_buffer_offset_alignment : 1;
+    if (align_arg != Py_None) {
+        align = to_int(align_arg);
+    }
+
+    if (align <= 0) {
+        PyErr_Format(PyExc_ValueError, "invalid align");
         return NULL;
     }
 
-    if (size.x <= 0 || size.y <= 0 || size.x > self->width || size.y > self->height) {
+    Py_buffer view = {0};
+    intptr size = 0;
+    if (data != Py_None) {
+        data = PyMemoryView_GetContiguous(data, PyBUF_READ, 'C');
+        if (!data) {
+            return NULL;
+        }
+        if (PyObject_GetBuffer(data, &view, PyBUF_SIMPLE)) {
+            Py_DECREF(data);
+            return NULL;
+        }
+        size = view.len;
+    } else {
+        size = to_intptr(size_arg);
+    }
+
+    if (size < 0 || size > self->size) {
+        if (data != Py_None) {
+            PyBuffer_Release(&view);
+            Py_DECREF(data);
+        }
         PyErr_Format(PyExc_ValueError, "invalid size");
         return NULL;
     }
 
-    if (offset.x < 0 || offset.y < 0 || size.x + offset.x > self->width || size.y + offset.y > self->height) {
-        PyErr_Format(PyExc_ValueError, "invalid offset");
-        return NULL;
+    Context * ctx = self->ctx;
+
+    if (self->stream_frame != ctx->frame_index) {
+        if (self->mapped && self->stream_frame_used) {
+            if (self->stream_fence_count == MAX_STREAM_FENCES) {
+                wait_stream_fence(self);
+            }
+            StreamFence * fence = &self->stream_fences[self->stream_fence_count++];
+            fence->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            fence->size = self->stream_frame_used;
+        }
+        if (!self->mapped && self->stream_head) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, self->buffer);
+            glBufferData(GL_COPY_WRITE_BUFFER, self->size, NULL, self->access);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            self->stream_head = 0;
+            self->stream_used = 0;
+        }
+        self->stream_frame = ctx->frame_index;
+        self->stream_frame_used = 0;
     }
 
-    if (layer < 0 || layer >= self->layer_count) {
-        PyErr_Format(PyExc_ValueError, "invalid layer");
+    intptr offset = (self->stream_head + align - 1) / align * align;
+    intptr consumed = offset + size - self->stream_head;
+    if (offset + size > self->size) {
+        offset = 0;
+        consumed = self->size - self->stream_head + size;
+    }
+
+    while (self->stream_used + consumed > self->size && self->stream_fence_count) {
+        wait_stream_fence(self);
+    }
+
+    if (self->stream_used + consumed > self->size) {
+        if (data != Py_None) {
+            PyBuffer_Release(&view);
+            Py_DECREF(data);
+        }
+        PyErr_Format(PyExc_ValueError, "the stream buffer is too small for a single frame");
         return NULL;
     }
 
-    if (level < 0 || level > self->level_count) {
-        PyErr_Format(PyExc_ValueError, "invalid level");
+    self->stream_head = offset + size;
+    self->stream_used += consumed;
+    self->stream_frame_used += consumed;
+
+    if (data != Py_None) {
+        if (size && self->mapped) {
+            copymem(self->mapped + offset, view.buf, size);
+        } else if (size) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, self->buffer);
+            buffer_sub_data(GL_COPY_WRITE_BUFFER, offset, size, (const char *)view.buf);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        PyBuffer_Release(&view);
+        Py_DECREF(data);
+    }
+
+    BufferView * res = PyObject_New(BufferView, ctx->module_state->BufferView_type);
+    res->buffer = (Buffer *)new_ref(self);
+    res->offset = offset;
+    res->size = size;
+    return res;
+}
+
+static BufferView * BufferArena_meth_allocate(BufferArena * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
         return NULL;
     }
 
-    if (!self->cubemap && !self->array && layer_arg != Py_None) {
-        PyErr_Format(PyExc_TypeError, "the image is not layered");
+    static char * keywords[] = {"data", "size", "align", NULL};
+
+    PyObject * data = Py_None;
+    PyObject * size_arg = Py_None;
+    int align = 4;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O$Oi", keywords, &data, &size_arg, &align)) {
         return NULL;
     }
 
-    if (!self->fmt.color) {
-        PyErr_Format(PyExc_TypeError, "cannot write to depth or stencil images");
+    if (size_arg != Py_None && !PyLong_CheckExact(size_arg)) {
+        PyErr_Format(PyExc_TypeError, "the size must be an int");
         return NULL;
     }
 
-    if (self->samples != 1) {
-        PyErr_Format(PyExc_TypeError, "cannot write to multisampled images");
+    if ((data == Py_None) == (size_arg == Py_None)) {
+        PyErr_Format(PyExc_ValueError, "either data or size is required");
         return NULL;
     }
 
-    int padded_row = (size.x * self->fmt.pixel_size + 3) & ~3;
-    int expected_size = padded_row * size.y;
+    if (align <= 0) {
+        PyErr_Format(PyExc_ValueError, "invalid align");
+        return NULL;
+    }
 
-    if (layer_arg == Py_None) {
-        expected_size *= self->layer_count;
+    PyObject * mem = NULL;
+    intptr size = 0;
+    if (data != Py_None) {
+        mem = PyMemoryView_GetContiguous(data, PyBUF_READ, 'C');
+        if (!mem) {
+            return NULL;
+        }
+        Py_buffer view;
+        if (PyObject_GetBuffer(mem, &view, PyBUF_SIMPLE)) {
+            Py_DECREF(mem);
+            return NULL;
+        }
+        size = view.len;
+        PyBuffer_Release(&view);
+    } else {
+        size = to_intptr(size_arg);
     }
 
-    glActiveTexture(self->ctx->default_texture_unit);
-    glBindTexture(self->target, self->image);
+    if (size <= 0 || size > self->buffer->size) {
+        Py_XDECREF(mem);
+        PyErr_Format(PyExc_ValueError, "invalid size");
+        return NULL;
+    }
 
-    BufferView * buffer_view = NULL;
+    int index = -1;
+    intptr offset = 0;
+    for (int i = 0; i <= self->count; ++i) {
+        const intptr start = i ? self->blocks[i - 1].view->offset + self->blocks[i - 1].view->size : 0;
+        const intptr end = i < self->count ? self->blocks[i].view->offset : self->buffer->size;
+        offset = (start + align - 1) / align * align;
+        if (offset <= end - size) {
+            index = i;
+            break;
+        }
+    }
 
-    if (Py_TYPE(data) == self->ctx->module_state->Buffer_type) {
-        buffer_view = (BufferView *)PyObject_CallMethod(data, "view", NULL);
+    if (index < 0) {
+        Py_XDECREF(mem);
+        PyErr_Format(PyExc_ValueError, "the arena has no free block for %zd bytes", size);
+        return NULL;
     }
 
-    if (Py_TYPE(data) == self->ctx->module_state->BufferView_type) {
-        buffer_view = (BufferView *)new_ref(data);
+    if (self->count == self->capacity) {
+        int capacity = self->capacity ? self->capacity * 2 : 64;
+        ArenaBlock * blocks = (ArenaBlock *)PyMem_Realloc(self->blocks, (size_t)capacity * sizeof(ArenaBlock));
+        if (!blocks) {
+            Py_XDECREF(mem);
+            return (BufferView *)PyErr_NoMemory();
+        }
+        self->blocks = blocks;
+        self->capacity = capacity;
     }
 
-    if (buffer_view) {
-        if (buffer_view->size != expected_size) {
-            PyErr_Format(PyExc_ValueError, "invalid data size, expected %d, got %d", expected_size, buffer_view->size);
+    if (mem) {
+        PyObject * written = PyObject_CallMethod((PyObject *)self->buffer, "write", "(On)", mem, offset);
+        Py_DECREF(mem);
+        if (!written) {
             return NULL;
         }
+        Py_DECREF(written);
+    }
 
-        char * ptr = (char *)(intptr)buffer_view->offset;
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_view->buffer->buffer);
+    BufferView * res = PyObject_New(BufferView, self->ctx->module_state->BufferView_type);
+    res->buffer = (Buffer *)new_ref(self->buffer);
+    res->offset = offset;
+    res->size = size;
 
-        if (self->cubemap) {
-            int stride = padded_row * size.y;
-            if (layer_arg != Py_None) {
-                int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer;
-                glTexSubImage2D(face, level, offset.x, offset.y, size.x, size.y, self->fmt.format, self->fmt.type, ptr);
-            } else {
-                for (int i = 0; i < 6; ++i) {
-                    int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
-                    glTexSubImage2D(face, level, offset.x, offset.y, size.x, size.y, self->fmt.format, self->fmt.type, ptr + stride * i);
-                }
-            }
-        } else if (self->array) {
-            if (layer_arg != Py_None) {
-                glTexSubImage3D(self->target, level, offset.x, offset.y, layer, size.x, size.y, 1, self->fmt.format, self->fmt.type, ptr);
+    for (int i = self->count; i > index; --i) {
+        self->blocks[i] = self->blocks[i - 1];
+    }
+    self->blocks[index].view = (BufferView *)new_ref(res);
+    self->blocks[index].align = align;
+    self->count += 1;
+    self->used += size;
+    return res;
+}
+
+static PyObject * BufferArena_meth_free(BufferArena * self, PyObject * arg) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    int index = -1;
+    if (Py_TYPE(arg) == self->ctx->module_state->BufferView_type) {
+        const intptr offset = ((BufferView *)arg)->offset;
+        int left = 0;
+        int right = self->count - 1;
+        while (left <= right) {
+            const int mid = (left + right) / 2;
+            if (self->blocks[mid].view->offset < offset) {
+                left = mid + 1;
+            } else if (self->blocks[mid].view->offset > offset) {
+                right = mid - 1;
             } else {
-                glTexSubImage3D(self->target, level, offset.x, offset.y, 0, size.x, size.y, self->array, self->fmt.format, self->fmt.type, ptr);
+                index = self->blocks[mid].view == (BufferView *)arg ? mid : -1;
+                break;
             }
-        } else {
-            glTexSubImage2D(self->target, level, offset.x, offset.y, size.x, size.y, self->fmt.format, self->fmt.type, ptr);
         }
-
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-
-        Py_DECREF(buffer_view);
-        Py_RETURN_NONE;
     }
 
-    PyObject * mem = PyMemoryView_GetContiguous(data, PyBUF_READ, 'C');
-    if (!mem) {
+    if (index < 0) {
+        PyErr_Format(PyExc_ValueError, "the view was not allocated from this arena");
         return NULL;
     }
 
-    Py_buffer view;
-    if (PyObject_GetBuffer(mem, &view, PyBUF_SIMPLE)) {
-        return NULL;
+    BufferView * view = self->blocks[index].view;
+    self->count -= 1;
+    self->used -= view->size;
+    for (int i = index; i < self->count; ++i) {
+        self->blocks[i] = self->blocks[i + 1];
     }
-    int data_size = (int)view.len;
+    Py_DECREF(view);
+    Py_RETURN_NONE;
+}
 
-    if (data_size != expected_size) {
-        PyErr_Format(PyExc_ValueError, "invalid data size, expected %d, got %d", expected_size, data_size);
+static PyObject * BufferArena_meth_defragment(BufferArena * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
         return NULL;
     }
 
-    if (self->cubemap) {
-        int stride = padded_row * size.y;
-        if (layer_arg != Py_None) {
-            int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer;
-            glTexSubImage2D(face, level, offset.x, offset.y, size.x, size.y, self->fmt.format, self->fmt.type, view.buf);
-        } else {
-            for (int i = 0; i < 6; ++i) {
-                int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + i;
-                glTexSubImage2D(face, level, offset.x, offset.y, size.x, size.y, self->fmt.format, self->fmt.type, (char *)view.buf + stride * i);
-            }
+    int first = self->count;
+    intptr base = 0;
+    intptr end = 0;
+    for (int i = 0; i < self->count; ++i) {
+        const int align = self->blocks[i].align;
+        const intptr offset = (end + align - 1) / align * align;
+        if (first == self->count && offset != self->blocks[i].view->offset) {
+            first = i;
+            base = offset;
         }
-    } else if (self->array) {
-        if (layer_arg != Py_None) {
-            glTexSubImage3D(self->target, level, offset.x, offset.y, layer, size.x, size.y, 1, self->fmt.format, self->fmt.type, view.buf);
-        } else {
-            glTexSubImage3D(self->target, level, offset.x, offset.y, 0, size.x, size.y, self->array, self->fmt.format, self->fmt.type, view.buf);
+        end = offset + self->blocks[i].view->size;
+    }
+
+    PyObject * moved = PyList_New(self->count - first);
+    if (!moved || first == self->count) {
+        return moved;
+    }
+
+    int temp = 0;
+    glGenBuffers(1, &temp);
+    glBindBuffer(GL_COPY_READ_BUFFER, self->buffer->buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, temp);
+    glBufferData(GL_COPY_WRITE_BUFFER, end - base, NULL, GL_STREAM_DRAW);
+
+    intptr offset = base;
+    for (int i = first; i < self->count; ++i) {
+        BufferView * view = self->blocks[i].view;
+        const int align = self->blocks[i].align;
+        offset = (offset + align - 1) / align * align;
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, view->offset, offset - base, view->size);
+        view->offset = offset;
+        offset += view->size;
+        PyList_SetItem(moved, i - first, new_ref(view));
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, temp);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, self->buffer->buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, base, end - base);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &temp);
+    return moved;
+}
+
+static PyObject * BufferArena_meth_stats(BufferArena * self, PyObject * args) {
+    intptr largest_free = 0;
+    int fragments = 0;
+    for (int i = 0; i <= self->count; ++i) {
+        const intptr start = i ? self->blocks[i - 1].view->offset + self->blocks[i - 1].view->size : 0;
+        const intptr end = i < self->count ? self->blocks[i].view->offset : self->buffer->size;
+        if (end > start) {
+            largest_free = end - start > largest_free ? end - start : largest_free;
+            fragments += 1;
         }
-    } else {
-        glTexSubImage2D(self->target, level, offset.x, offset.y, size.x, size.y, self->fmt.format, self->fmt.type, view.buf);
     }
+    return Py_BuildValue(
+        "{snsnsnsnsisi}",
+        "size", self->buffer->size,
+        "used", self->used,
+        "free", self->buffer->size - self->used,
+        "largest_free", largest_free,
+        "allocations", self->count,
+        "fragments", fragments
+    );
+}
 
-    PyBuffer_Release(&view);
-    Py_DECREF(mem);
-    Py_RETURN_NONE;
+static Py_ssize_t BufferArena_len(BufferArena * self) {
+    return self->count;
 }
 
-static PyObject * Image_meth_mipmaps(Image * self, PyObject * args) {
-    glActiveTexture(self->ctx->default_texture_unit);
-    glBindTexture(self->target, self->image);
-    glGenerateMipmap(self->target);
-    Py_RETURN_NONE;
+static void write_image_2d(Image * self, int target, int level, IntPair size, IntPair offset, intptr data_size, const void * ptr) {
+    if (self->fmt.compressed) {
+        glCompressedTexSubImage2D(target, level, offset.x, offset.y, size.x, size.y, self->fmt.internal_format, (int)data_size, ptr);
+    } else {
+        glTexSubImage2D(target, level, offset.x, offset.y, size.x, size.y, self->fmt.format, self->fmt.type, ptr);
+    }
 }
 
-static PyObject * Image_meth_read(Image * self, PyObject * args, PyObject * kwargs) {
-    static char * keywords[] = {"size", "offset", "into", NULL};
+static void write_image_3d(Image * self, int level, IntPair size, IntPair offset, int layer, int layers, intptr data_size, const void * ptr) {
+    if (self->fmt.compressed) {
+        glCompressedTexSubImage3D(self->target, level, offset.x, offset.y, layer, size.x, size.y, layers, self->fmt.internal_format, (int)data_size, ptr);
+    } else {
+        glTexSubImage3D(self->target, level, offset.x, offset.y, layer, size.x, size.y, layers, self->fmt.format, self->fmt.type, ptr);
+    }
+}
 
-    PyObject * size_arg = Py_None;
-    PyObject * offset_arg = Py_None;
-    PyObject * into = Py_None;
+static unsigned pack_rgb9e5(const float * rgb) {
+    const float max_value = 65408.0f;
+    float max_component = 0.0f;
+    float components[3];
+    for (int i = 0; i < 3; ++i) {
+        components[i] = rgb[i] > 0.0f ? (rgb[i] < max_value ? rgb[i] : max_value) : 0.0f;
+        max_component = components[i] > max_component ? components[i] : max_component;
+    }
+    unsigned exponent = 0;
+    float scale = 1.0f / 65536.0f;
+    while (exponent < 31 && scale * 2.0f <= max_component) {
+        scale *= 2.0f;
+        exponent += 1;
+    }
+    float unit = scale / 256.0f;
+    if ((unsigned)(max_component / unit + 0.5f) == 512) {
+        exponent += 1;
+        unit *= 2.0f;
+    }
+    unsigned res = exponent << 27;
+    for (int i = 0; i < 3; ++i) {
+        res |= (unsigned)(components[i] / unit + 0.5f) << (9 * i);
+    }
+    return res;
+}
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOO", keywords, &size_arg, &offset_arg, &into)) {
-        return NULL;
+static int clear_shared_exponent_face(ImageFace * face) {
+    Image * image = face->image;
+    const unsigned value = pack_rgb9e5(image->clear_value.clear_floats);
+    const intptr count = (intptr)face->width * (intptr)face->height;
+    unsigned * pixels = (unsigned *)PyMem_Malloc((size_t)count * sizeof(unsigned));
+    if (!pixels) {
+        PyErr_NoMemory();
+        return 0;
+    }
+    for (intptr i = 0; i < count; ++i) {
+        pixels[i] = value;
+    }
+    IntPair size = {face->width, face->height};
+    IntPair offset = {0, 0};
+    bind_default_texture(image->ctx, image->target, image->image);
+    if (image->cubemap) {
+        write_image_2d(image, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face->layer, face->level, size, offset, count * 4, pixels);
+    } else if (image->array) {
+        write_image_3d(image, face->level, size, offset, face->layer, 1, count * 4, pixels);
+    } else {
+        write_image_2d(image, image->target, face->level, size, offset, count * 4, pixels);
     }
+    PyMem_Free(pixels);
+    return 1;
+}
 
-    IntPair size, offset;
-    ImageFace * first_layer = (ImageFace *)PyTuple_GetItem(self->layers, 0);
-    if (!parse_size_and_offset(first_layer, size_arg, offset_arg, &size, &offset)) {
+static PyObject * Image_meth_clear(Image * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
         return NULL;
     }
 
-    if (self->array || self->cubemap) {
-        if (into != Py_None) {
-            // TODO:
-            return NULL;
-        }
-
-        int write_size = size.x * size.y * self->fmt.pixel_size;
-        PyObject * res = PyBytes_FromStringAndSize(NULL, write_size * self->layer_count);
-        for (int i = 0; i < self->layer_count; ++i) {
-            ImageFace * src = (ImageFace *)PyTuple_GetItem(self->layers, i);
-            PyObject * chunk = PyMemoryView_FromMemory(PyBytes_AsString(res) + write_size * i, write_size, PyBUF_WRITE);
-            PyObject * temp = read_image_face(src, size, offset, chunk);
-            if (!temp) {
+    if (self->fmt.compressed) {
+        PyErr_Format(PyExc_TypeError, "cannot clear compressed images");
+        return NULL;
+    }
+    int event = profile_begin(self->ctx, "clear", Py_None);
+    const int count = (int)PyTuple_Size(self->layers);
+    for (int i = 0; i < count; ++i) {
+        ImageFace * face = (ImageFace *)PyTuple_GetItem(self->layers, i);
+        if (self->fmt.clear_type == 'e') {
+            if (!clear_shared_exponent_face(face)) {
+                profile_end(self->ctx, event);
                 return NULL;
             }
-            Py_DECREF(chunk);
-            Py_DECREF(temp);
+            continue;
         }
-        return res;
+        bind_draw_framebuffer(self->ctx, face->framebuffer->obj);
+        clear_bound_image(self);
     }
-
-    return read_image_face(first_layer, size, offset, into);
+    profile_end(self->ctx, event);
+    Py_RETURN_NONE;
 }
 
-static PyObject * Image_meth_blit(Image * self, PyObject * args, PyObject * kwargs) {
-    static char * keywords[] = {"target", "target_viewport", "source_viewport", "filter", NULL};
+static int parse_image_levels(Image * self, PyObject * levels_arg, int level, int * res) {
+    if (levels_arg == Py_None) {
+        *res = 1;
+        return 1;
+    }
+    if (PyUnicode_CheckExact(levels_arg) && !PyUnicode_CompareWithASCIIString(levels_arg, "all")) {
+        *res = self->level_count - level;
+    } else if (PyLong_CheckExact(levels_arg)) {
+        *res = to_int(levels_arg);
+    } else {
+        PyErr_Format(PyExc_TypeError, "the levels must be an int, \"all\" or None");
+        return 0;
+    }
+    if (level < 0 || *res < 1 || level + *res > self->level_count) {
+        PyErr_Format(PyExc_ValueError, "invalid levels");
+        return 0;
+    }
+    return 1;
+}
 
-    PyObject * target = Py_None;
-    PyObject * target_viewport = Py_None;
-    PyObject * source_viewport = Py_None;
-    int filter = 1;
+static intptr image_row_size(Image * self, int width) {
+    if (self->fmt.compressed) {
+        return (intptr)((width + self->fmt.block_width - 1) / self->fmt.block_width) * (intptr)self->fmt.pixel_size;
+    }
+    return ((intptr)width * (intptr)self->fmt.pixel_size + 3) & ~3;
+}
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOOp", keywords, &target, &target_viewport, &source_viewport, &filter)) {
-        return NULL;
+static int image_row_count(Image * self, int height) {
+    if (self->fmt.compressed) {
+        return (height + self->fmt.block_height - 1) / self->fmt.block_height;
     }
+    return height;
+}
 
-    ImageFace * src = (ImageFace *)PyTuple_GetItem(self->layers, 0);
-    return blit_image_face(src, target, source_viewport, target_viewport, filter);
+static void write_image_level(Image * self, int level, IntPair size, IntPair offset, int layer, int layers, intptr stride, const char * ptr) {
+    if (self->cubemap) {
+        for (int i = 0; i < layers; ++i) {
+            int face = GL_TEXTURE_CUBE_MAP_POSITIVE_X + layer + i;
+            write_image_2d(self, face, level, size, offset, stride, ptr + stride * i);
+        }
+    } else if (self->array) {
+        write_image_3d(self, level, size, offset, layer, layers, stride * layers, ptr);
+    } else {
+        write_image_2d(self, self->target, level, size, offset, stride, ptr);
+    }
 }
 
-static ImageFace * Image_meth_face(Image * self, PyObject * args, PyObject * kwargs) {
-    static char * keywords[] = {"layer", "level", NULL};
+static PyObject * Image_meth_write(Image * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
 
-    int layer = 0;
+    static char * keywords[] = {"data", "size", "offset", "layer", "level", "levels", NULL};
+
+    PyObject * data;
+    PyObject * size_arg = Py_None;
+    PyObject * offset_arg = Py_None;
+    PyObject * layer_arg = Py_None;
     int level = 0;
+    PyObject * levels_arg = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OOOiO", keywords, &data, &size_arg, &offset_arg, &layer_arg, &level, &levels_arg)) {
+        return NULL;
+    }
+
+    if (layer_arg != Py_None && !PyLong_CheckExact(layer_arg)) {
+        PyErr_Format(PyExc_TypeError, "the layer must be an int or None");
+        return NULL;
+    }
+
+    int layer = 0;
+    if (layer_arg != Py_None) {
+        layer = to_int(layer_arg);
+    }
+
+    int levels = 1;
+    if (!parse_image_levels(self, levels_arg, level, &levels)) {
+        return NULL;
+    }
+
+    if (levels_arg != Py_None && (size_arg != Py_None || offset_arg != Py_None)) {
+        PyErr_Format(PyExc_ValueError, "the size and offset must be None when writing levels");
+        return NULL;
+    }
+
+    IntPair size = to_int_pair(size_arg, least_one(self->width >> level), least_one(self->height >> level));
+    if (PyErr_Occurred()) {
+        PyErr_Format(PyExc_TypeError, "the size must be a tuple of 2 ints");
+        return NULL;
+    }
+
+    IntPair offset = to_int_pair(offset_arg, 0, 0);
+    if (PyErr_Occurred()) {
+        PyErr_Format(PyExc_TypeError, "the offset must be a tuple of 2 ints");
+        return NULL;
+    }
+
+    if (size_arg == Py_None && offset_arg != Py_None) {
+        PyErr_Format(PyExc_ValueError, "the size is required when the offset is not None");
+        return NULL;
+    }
+
+    if (size.x <= 0 || size.y <= 0 || size.x > self->width || size.y > self->height) {
+        PyErr_Format(PyExc_ValueError, "invalid size");
+        return NULL;
+    }
+
+    if (offset.x < 0 || offset.y < 0 || size.x + offset.x > self->width || size.y + offset.y > self->height) {
+        PyErr_Format(PyExc_ValueError, "invalid offset");
+        return NULL;
+    }
+
+    if (layer < 0 || layer >= self->layer_count) {
+        PyErr_Format(PyExc_ValueError, "invalid layer");
+        return NULL;
+    }
+
+    if (level < 0 || level > self->level_count) {
+        PyErr_Format(PyExc_ValueError, "invalid level");
+        return NULL;
+    }
+
+    if (!self->cubemap && !self->array && layer_arg != Py_None) {
+        PyErr_Format(PyExc_TypeError, "the image is not layered");
+        return NULL;
+    }
+
+    if (!self->fmt.color) {
+        PyErr_Format(PyExc_TypeError, "cannot write to depth or stencil images");
+        return NULL;
+    }
+
+    if (self->samples != 1) {
+        PyErr_Format(PyExc_TypeError, "cannot write to multisampled images");
+        return NULL;
+    }
+
+    if (self->fmt.compressed) {
+        const int bw = self->fmt.block_width;
+        const int bh = self->fmt.block_height;
+        const int level_width = least_one(self->width >> level);
+        const int level_height = least_one(self->height >> level);
+        if (offset.x % bw || offset.y % bh || (size.x % bw && offset.x + size.x != level_width) || (size.y % bh && offset.y + size.y != level_height)) {
+            PyErr_Format(PyExc_ValueError, "the size and offset must be aligned to %dx%d blocks", bw, bh);
+            return NULL;
+        }
+    }
+
+    const int layers = layer_arg == Py_None ? self->layer_count : 1;
+
+    intptr expected_size = 0;
+    for (int i = 0; i < levels; ++i) {
+        if (levels_arg != Py_None) {
+            size.x = least_one(self->width >> (level + i));
+            size.y = least_one(self->height >> (level + i));
+        }
+        expected_size += image_row_size(self, size.x) * (intptr)image_row_count(self, size.y) * layers;
+    }
+
+    bind_default_texture(self->ctx, self->target, self->image);
+
+    BufferView * buffer_view = NULL;
+
+    if (Py_TYPE(data) == self->ctx->module_state->Buffer_type) {
+        buffer_view = (BufferView *)PyObject_CallMethod(data, "view", NULL);
+    }
+
+    if (Py_TYPE(data) == self->ctx->module_state->BufferView_type) {
+        buffer_view = (BufferView *)new_ref(data);
+    }
+
+    const char * ptr = NULL;
+    Py_buffer view;
+    PyObject * mem = NULL;
+    intptr row_stride = 0;
+    intptr layer_stride = 0;
+
+    if (buffer_view) {
+        if (buffer_view->size != expected_size) {
+            PyErr_Format(PyExc_ValueError, "invalid data size, expected %zd, got %zd", expected_size, buffer_view->size);
+            Py_DECREF(buffer_view);
+            return NULL;
+        }
+        ptr = (const char *)buffer_view->offset;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer_view->buffer->buffer);
+    } else if (levels_arg == Py_None && get_strided_pixels(self, data, size, layers, 0, &view, &row_stride, &layer_stride)) {
+        ptr = (const char *)view.buf;
+    } else {
+        mem = PyMemoryView_GetContiguous(data, PyBUF_READ, 'C');
+        if (!mem) {
+            return NULL;
+        }
+
+        if (PyObject_GetBuffer(mem, &view, PyBUF_SIMPLE)) {
+            Py_DECREF(mem);
+            return NULL;
+        }
+
+        if (view.len != expected_size) {
+            PyErr_Format(PyExc_ValueError, "invalid data size, expected %zd, got %zd", expected_size, view.len);
+            PyBuffer_Release(&view);
+            Py_DECREF(mem);
+            return NULL;
+        }
+        ptr = (const char *)view.buf;
+    }
+
+    PyThreadState * thread_state = !buffer_view && expected_size >= LARGE_UPLOAD_SIZE ? PyEval_SaveThread() : NULL;
+
+    if (row_stride) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, (int)(row_stride / self->fmt.pixel_size));
+        glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, (int)(layer_stride / row_stride));
+        write_image_level(self, level, size, offset, layer, layers, layer_stride, ptr);
+        glPixelStorei(GL_UNPACK_IMAGE_HEIGHT, 0);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    for (int i = 0; i < levels && !row_stride; ++i) {
+        if (levels_arg != Py_None) {
+            size.x = least_one(self->width >> (level + i));
+            size.y = least_one(self->height >> (level + i));
+        }
+        const intptr stride = image_row_size(self, size.x) * (intptr)image_row_count(self, size.y);
+        write_image_level(self, level + i, size, offset, layer, layers, stride, ptr);
+        ptr += stride * layers;
+    }
+
+    if (thread_state) {
+        PyEval_RestoreThread(thread_state);
+    }
+
+    if (buffer_view) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        Py_DECREF(buffer_view);
+        Py_RETURN_NONE;
+    }
+
+    PyBuffer_Release(&view);
+    Py_XDECREF(mem);
+    Py_RETURN_NONE;
+}
+
+static PyObject * Image_meth_mipmaps(Image * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    if (self->fmt.compressed) {
+        PyErr_Format(PyExc_TypeError, "cannot generate mipmaps for compressed images");
+        return NULL;
+    }
+    bind_default_texture(self->ctx, self->target, self->image);
+    glGenerateMipmap(self->target);
+    Py_RETURN_NONE;
+}
+
+static PyObject * read_image_levels(Image * self, int levels, PyObject * into) {
+    intptr total_size = 0;
+    for (int level = 0; level < levels; ++level) {
+        const int width = least_one(self->width >> level);
+        const int height = least_one(self->height >> level);
+        total_size += image_row_size(self, width) * (intptr)height * self->layer_count;
+    }
+
+    PyObject * res = NULL;
+    BufferView * buffer_view = NULL;
+    Py_buffer view;
+    char * ptr = NULL;
+
+    if (into == Py_None) {
+        res = PyBytes_FromStringAndSize(NULL, total_size);
+        ptr = PyBytes_AsString(res);
+        if (self->fmt.pixel_size % 4) {
+            for (intptr i = 0; i < total_size; ++i) {
+                ptr[i] = 0;
+            }
+        }
+    } else if (Py_TYPE(into) == self->ctx->module_state->Buffer_type || Py_TYPE(into) == self->ctx->module_state->BufferView_type) {
+        if (Py_TYPE(into) == self->ctx->module_state->Buffer_type) {
+            buffer_view = (BufferView *)PyObject_CallMethod(into, "view", NULL);
+        } else {
+            buffer_view = (BufferView *)new_ref(into);
+        }
+        if (total_size > buffer_view->size) {
+            Py_DECREF(buffer_view);
+            PyErr_Format(PyExc_ValueError, "invalid size");
+            return NULL;
+        }
+    } else {
+        if (PyObject_GetBuffer(into, &view, PyBUF_WRITABLE)) {
+            return NULL;
+        }
+        if (view.len < total_size) {
+            PyBuffer_Release(&view);
+            PyErr_Format(PyExc_ValueError, "invalid write size");
+            return NULL;
+        }
+        ptr = (char *)view.buf;
+    }
+
+    intptr position = 0;
+    for (int level = 0; level < levels; ++level) {
+        IntPair size = {least_one(self->width >> level), least_one(self->height >> level)};
+        IntPair offset = {0, 0};
+        const intptr stride = image_row_size(self, size.x) * (intptr)size.y;
+        for (int layer = 0; layer < self->layer_count; ++layer) {
+            PyObject * key = Py_BuildValue("(ii)", layer, level);
+            ImageFace * face = build_image_face(self, key);
+            Py_DECREF(key);
+            PyObject * chunk = NULL;
+            if (buffer_view) {
+                chunk = PyObject_CallMethod((PyObject *)buffer_view->buffer, "view", "nn", stride, buffer_view->offset + position);
+            } else {
+                chunk = PyMemoryView_FromMemory(ptr + position, stride, PyBUF_WRITE);
+            }
+            PyObject * temp = read_image_face(face, size, offset, chunk);
+            Py_DECREF(chunk);
+            Py_DECREF(face);
+            if (!temp) {
+                if (buffer_view) {
+                    Py_DECREF(buffer_view);
+                } else if (into != Py_None) {
+                    PyBuffer_Release(&view);
+                }
+                Py_XDECREF(res);
+                return NULL;
+            }
+            Py_DECREF(temp);
+            position += stride;
+        }
+    }
+
+    if (buffer_view) {
+        Py_DECREF(buffer_view);
+    } else if (into != Py_None) {
+        PyBuffer_Release(&view);
+    }
+
+    if (res) {
+        return res;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject * Image_meth_read(Image * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"size", "offset", "into", "levels", NULL};
+
+    PyObject * size_arg = Py_None;
+    PyObject * offset_arg = Py_None;
+    PyObject * into = Py_None;
+    PyObject * levels_arg = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOOO", keywords, &size_arg, &offset_arg, &into, &levels_arg)) {
+        return NULL;
+    }
+
+    if (levels_arg != Py_None) {
+        int levels = 1;
+        if (!parse_image_levels(self, levels_arg, 0, &levels)) {
+            return NULL;
+        }
+        if (size_arg != Py_None || offset_arg != Py_None) {
+            PyErr_Format(PyExc_ValueError, "the size and offset must be None when reading levels");
+            return NULL;
+        }
+        return read_image_levels(self, levels, into);
+    }
+
+    IntPair size, offset;
+    ImageFace * first_layer = (ImageFace *)PyTuple_GetItem(self->layers, 0);
+    if (!parse_size_and_offset(first_layer, size_arg, offset_arg, &size, &offset)) {
+        return NULL;
+    }
+
+    if (self->array || self->cubemap) {
+        if (into != Py_None) {
+            // TODO:
+            return NULL;
+        }
+
+        intptr write_size = (intptr)size.x * (intptr)size.y * (intptr)self->fmt.pixel_size;
+        PyObject * res = PyBytes_FromStringAndSize(NULL, write_size * self->layer_count);
+        for (int i = 0; i < self->layer_count; ++i) {
+            ImageFace * src = (ImageFace *)PyTuple_GetItem(self->layers, i);
+            PyObject * chunk = PyMemoryView_FromMemory(PyBytes_AsString(res) + write_size * i, write_size, PyBUF_WRITE);
+            PyObject * temp = read_image_face(src, size, offset, chunk);
+            if (!temp) {
+                return NULL;
+            }
+            Py_DECREF(chunk);
+            Py_DECREF(temp);
+        }
+        return res;
+    }
+
+    return read_image_face(first_layer, size, offset, into);
+}
+
+static Readback * Image_meth_read_async(Image * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"size", "offset", NULL};
+
+    PyObject * size_arg = Py_None;
+    PyObject * offset_arg = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OO", keywords, &size_arg, &offset_arg)) {
+        return NULL;
+    }
+
+    IntPair size, offset;
+    ImageFace * first_layer = (ImageFace *)PyTuple_GetItem(self->layers, 0);
+    if (!parse_size_and_offset(first_layer, size_arg, offset_arg, &size, &offset)) {
+        return NULL;
+    }
+
+    return read_image_faces_async(self, self->layers, size, offset);
+}
+
+static Image * Image_meth_resolve(Image * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    if (self->samples == 1) {
+        PyErr_Format(PyExc_TypeError, "the image is not multisampled");
+        return NULL;
+    }
+    IntPair size = {self->width, self->height};
+    IntPair offset = {0, 0};
+    ImageFace * res = resolve_image_face((ImageFace *)PyTuple_GetItem(self->layers, 0), size, offset);
+    if (!res) {
+        return NULL;
+    }
+    return (Image *)new_ref(res->image);
+}
+
+static PyObject * Image_meth_blit(Image * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"target", "target_viewport", "source_viewport", "filter", NULL};
+
+    PyObject * target = Py_None;
+    PyObject * target_viewport = Py_None;
+    PyObject * source_viewport = Py_None;
+    int filter = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OOOp", keywords, &target, &target_viewport, &source_viewport, &filter)) {
+        return NULL;
+    }
+
+    ImageFace * src = (ImageFace *)PyTuple_GetItem(self->layers, 0);
+    return blit_image_face(src, target, source_viewport, target_viewport, filter);
+}
+
+static ImageFace * Image_meth_face(Image * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"layer", "level", NULL};
+
+    int layer = 0;
+    int level = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|ii", keywords, &layer, &level)) {
+        return NULL;
+    }
+
+    if (layer < 0 || layer >= self->layer_count) {
+        PyErr_Format(PyExc_ValueError, "invalid layer");
+        return NULL;
+    }
+
+    if (level > self->level_count) {
+        PyErr_Format(PyExc_ValueError, "invalid level");
+        return NULL;
+    }
+
+    PyObject * key = Py_BuildValue("(ii)", layer, level);
+    ImageFace * res = build_image_face(self, key);
+    Py_DECREF(key);
+    return res;
+}
+
+static PyObject * Image_get_clear_value(Image * self, void * closure) {
+    if (self->fmt.clear_type == 'x') {
+        return Py_BuildValue("dI", (double)self->clear_value.clear_floats[0], self->clear_value.clear_uints[1]);
+    }
+    if (self->fmt.components == 1) {
+        if (self->fmt.clear_type == 'f') {
+            return PyFloat_FromDouble(self->clear_value.clear_floats[0]);
+        } else if (self->fmt.clear_type == 'i') {
+            return PyLong_FromLong(self->clear_value.clear_ints[0]);
+        } else if (self->fmt.clear_type == 'u') {
+            return PyLong_FromUnsignedLong(self->clear_value.clear_uints[0]);
+        }
+    }
+    PyObject * res = PyTuple_New(self->fmt.components);
+    for (int i = 0; i < self->fmt.components; ++i) {
+        if (self->fmt.clear_type == 'f' || self->fmt.clear_type == 'e') {
+            PyTuple_SetItem(res, i, PyFloat_FromDouble(self->clear_value.clear_floats[i]));
+        } else if (self->fmt.clear_type == 'i') {
+            PyTuple_SetItem(res, i, PyLong_FromLong(self->clear_value.clear_ints[i]));
+        } else if (self->fmt.clear_type == 'u') {
+            PyTuple_SetItem(res, i, PyLong_FromUnsignedLong(self->clear_value.clear_uints[i]));
+        }
+    }
+    return res;
+}
+
+static int Image_set_clear_value(Image * self, PyObject * value, void * closure) {
+    if (!check_context_idle(self->ctx)) {
+        return -1;
+    }
+
+    if (self->fmt.components == 1) {
+        if (self->fmt.clear_type == 'f' && !PyFloat_CheckExact(value)) {
+            PyErr_Format(PyExc_TypeError, "the clear value must be a float");
+            return -1;
+        }
+        if (self->fmt.clear_type == 'i' && !PyLong_CheckExact(value)) {
+            PyErr_Format(PyExc_TypeError, "the clear value must be an int");
+            return -1;
+        }
+        if (self->fmt.clear_type == 'f') {
+            self->clear_value.clear_floats[0] = to_float(value);
+        } else if (self->fmt.clear_type == 'i') {
+            self->clear_value.clear_ints[0] = to_int(value);
+        } else if (self->fmt.clear_type == 'u') {
+            self->clear_value.clear_uints[0] = to_uint(value);
+        }
+        return 0;
+    }
+    PyObject * values = PySequence_Tuple(value);
+    if (!values) {
+        PyErr_Clear();
+        PyErr_Format(PyExc_TypeError, "the clear value must be a tuple");
+        return -1;
+    }
+
+    int size = (int)PyTuple_Size(values);
+
+    if (size != self->fmt.components) {
+        Py_DECREF(values);
+        PyErr_Format(PyExc_ValueError, "invalid clear value size");
+        return -1;
+    }
+
+    if (self->fmt.clear_type == 'f' || self->fmt.clear_type == 'e') {
+        for (int i = 0; i < self->fmt.components; ++i) {
+            self->clear_value.clear_floats[i] = to_float(PyTuple_GetItem(values, i));
+        }
+    } else if (self->fmt.clear_type == 'i') {
+        for (int i = 0; i < self->fmt.components; ++i) {
+            self->clear_value.clear_ints[i] = to_int(PyTuple_GetItem(values, i));
+        }
+    } else if (self->fmt.clear_type == 'u') {
+        for (int i = 0; i < self->fmt.components; ++i) {
+            self->clear_value.clear_uints[i] = to_uint(PyTuple_GetItem(values, i));
+        }
+    } else if (self->fmt.clear_type == 'x') {
+        self->clear_value.clear_floats[0] = to_float(PyTuple_GetItem(values, 0));
+        self->clear_value.clear_ints[1] = to_int(PyTuple_GetItem(values, 1));
+    }
+    if (PyErr_Occurred()) {
+        Py_DECREF(values);
+        return -1;
+    }
+    Py_DECREF(values);
+    return 0;
+}
+
+static PyObject * Pipeline_meth_render(Pipeline * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    render_pipeline(self);
+    Py_RETURN_NONE;
+}
+
+static int draw_command_less(DrawCommand * a, DrawCommand * b) {
+    Pipeline * x = a->pipeline;
+    Pipeline * y = b->pipeline;
+    if (x->framebuffer->obj != y->framebuffer->obj) {
+        return x->framebuffer->obj < y->framebuffer->obj;
+    }
+    if (x->program->obj != y->program->obj) {
+        return x->program->obj < y->program->obj;
+    }
+    if (x->vertex_array->obj != y->vertex_array->obj) {
+        return x->vertex_array->obj < y->vertex_array->obj;
+    }
+    if (x->descriptor_set != y->descriptor_set) {
+        return (intptr)x->descriptor_set < (intptr)y->descriptor_set;
+    }
+    if (x->global_settings != y->global_settings) {
+        return (intptr)x->global_settings < (intptr)y->global_settings;
+    }
+    if (a->depth != b->depth) {
+        return a->depth < b->depth;
+    }
+    return a->dynamic_offset < b->dynamic_offset;
+}
+
+static void sort_draw_commands(DrawCommand * commands, DrawCommand * temp, int count) {
+    for (int width = 1; width < count; width *= 2) {
+        for (int left = 0; left < count; left += width * 2) {
+            int mid = left + width < count ? left + width : count;
+            int right = left + width * 2 < count ? left + width * 2 : count;
+            int i = left;
+            int j = mid;
+            int k = left;
+            while (i < mid && j < right) {
+                temp[k++] = draw_command_less(&commands[j], &commands[i]) ? commands[j++] : commands[i++];
+            }
+            while (i < mid) {
+                temp[k++] = commands[i++];
+            }
+            while (j < right) {
+                temp[k++] = commands[j++];
+            }
+        }
+        copymem(commands, temp, count * (int)sizeof(DrawCommand));
+    }
+}
+
+static int count_draw_binds(DrawCommand * commands, int count) {
+    int binds = 0;
+    for (int i = 1; i < count; ++i) {
+        Pipeline * x = commands[i - 1].pipeline;
+        Pipeline * y = commands[i].pipeline;
+        binds += x->framebuffer->obj != y->framebuffer->obj;
+        binds += x->program->obj != y->program->obj;
+        binds += x->vertex_array->obj != y->vertex_array->obj;
+        binds += x->descriptor_set != y->descriptor_set;
+        binds += x->global_settings != y->global_settings;
+    }
+    return binds;
+}
+
+static void clear_draw_queue(DrawQueue * self) {
+    int count = self->count;
+    self->count = 0;
+    self->uniform_size = 0;
+    for (int i = 0; i < count; ++i) {
+        Py_DECREF(self->commands[i].pipeline);
+    }
+}
+
+static int check_draw_queue_idle(DrawQueue * self) {
+    if (self->flushing) {
+        PyErr_Format(PyExc_RuntimeError, "the draw queue is being flushed");
+        return 0;
+    }
+    return 1;
+}
+
+static PyObject * DrawQueue_meth_add(DrawQueue * self, PyObject * args, PyObject * kwargs) {
+    static char * keywords[] = {"pipeline", "depth", NULL};
+
+    PyObject * pipeline;
+    double depth = 0.0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|d", keywords, &pipeline, &depth)) {
+        return NULL;
+    }
+
+    if (!check_draw_queue_idle(self)) {
+        return NULL;
+    }
+
+    if (Py_TYPE(pipeline) != self->ctx->module_state->Pipeline_type) {
+        PyErr_Format(PyExc_TypeError, "pipeline must be a Pipeline object");
+        return NULL;
+    }
+
+    if (self->count == self->capacity) {
+        int capacity = self->capacity ? self->capacity * 2 : 64;
+        DrawCommand * commands = (DrawCommand *)PyMem_Realloc(self->commands, (size_t)capacity * sizeof(DrawCommand));
+        if (!commands) {
+            return PyErr_NoMemory();
+        }
+        self->commands = commands;
+        self->capacity = capacity;
+    }
+
+    Pipeline * source = (Pipeline *)pipeline;
+    intptr uniform_offset = 0;
+    if (source->uniforms) {
+        const intptr size = source->uniform_data_buffer.len;
+        if (self->uniform_size + size > self->uniform_capacity) {
+            intptr capacity = self->uniform_capacity ? self->uniform_capacity * 2 : 4096;
+            while (capacity < self->uniform_size + size) {
+                capacity *= 2;
+            }
+            char * uniform_data = (char *)PyMem_Realloc(self->uniform_data, (size_t)capacity);
+            if (!uniform_data) {
+                return PyErr_NoMemory();
+            }
+            self->uniform_data = uniform_data;
+            self->uniform_capacity = capacity;
+        }
+        uniform_offset = self->uniform_size;
+        copymem(self->uniform_data + uniform_offset, source->uniform_data_buffer.buf, size);
+        self->uniform_size += size;
+    }
+
+    DrawCommand * command = &self->commands[self->count];
+    command->pipeline = (Pipeline *)new_ref(pipeline);
+    command->depth = depth;
+    command->dynamic_offset = source->dynamic_offset;
+    command->uniform_offset = uniform_offset;
+    command->viewport = *(Viewport *)source->viewport_data_buffer.buf;
+    zeromem(&command->params, sizeof(RenderParameters));
+    copymem(&command->params, source->render_data_buffer.buf, source->render_data_buffer.len);
+    command->indirect_count = source->indirect_count;
+    self->count += 1;
+    Py_RETURN_NONE;
+}
+
+static PyObject * DrawQueue_meth_flush(DrawQueue * self, PyObject * args) {
+    if (!check_draw_queue_idle(self) || !check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    self->saved_binds = 0;
+    if (self->sort && self->count > 1) {
+        DrawCommand * temp = (DrawCommand *)PyMem_Malloc((size_t)self->count * sizeof(DrawCommand));
+        if (!temp) {
+            return PyErr_NoMemory();
+        }
+        int binds = count_draw_binds(self->commands, self->count);
+        sort_draw_commands(self->commands, temp, self->count);
+        self->saved_binds = binds - count_draw_binds(self->commands, self->count);
+        PyMem_Free(temp);
+    }
+
+    if (self->ctx->profile_running) {
+        for (int i = 0; i < self->count; ++i) {
+            render_command(&self->commands[i], self->uniform_data);
+        }
+    } else {
+        Context * ctx = self->ctx;
+        DrawCommand * commands = self->commands;
+        const char * uniform_data = self->uniform_data;
+        int count = self->count;
+        self->flushing = 1;
+        ctx->flushing += 1;
+        Py_BEGIN_ALLOW_THREADS
+        for (int i = 0; i < count; ++i) {
+            render_command(&commands[i], uniform_data);
+        }
+        Py_END_ALLOW_THREADS
+        ctx->flushing -= 1;
+        self->flushing = 0;
+    }
+
+    clear_draw_queue(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject * DrawQueue_meth_clear(DrawQueue * self, PyObject * args) {
+    if (!check_draw_queue_idle(self)) {
+        return NULL;
+    }
+    clear_draw_queue(self);
+    Py_RETURN_NONE;
+}
+
+static Py_ssize_t DrawQueue_len(DrawQueue * self) {
+    return self->count;
+}
+
+static PyObject * Pipeline_meth_render_multi(Pipeline * self, PyObject * arg) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    if (self->indirect_buffer) {
+        PyErr_Format(PyExc_ValueError, "cannot use render_multi with an indirect_buffer");
+        return NULL;
+    }
+
+    PyObject * mem = PyMemoryView_GetContiguous(arg, PyBUF_READ, 'C');
+    if (!mem) {
+        return NULL;
+    }
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(mem, &view, PyBUF_SIMPLE)) {
+        Py_DECREF(mem);
+        return NULL;
+    }
+
+    if (view.len % (Py_ssize_t)sizeof(RenderParameters)) {
+        PyBuffer_Release(&view);
+        Py_DECREF(mem);
+        PyErr_Format(PyExc_ValueError, "the render data must be a sequence of (vertex_count, instance_count, first_vertex, base_vertex, base_instance) ints");
+        return NULL;
+    }
+
+    RenderParameters * params = (RenderParameters *)view.buf;
+    int count = (int)(view.len / (Py_ssize_t)sizeof(RenderParameters));
+
+    for (int i = 0; i < count; ++i) {
+        if ((params[i].base_vertex && !self->ctx->base_vertex_support) || (params[i].base_instance && !self->ctx->base_instance_support)) {
+            PyBuffer_Release(&view);
+            Py_DECREF(mem);
+            PyErr_Format(PyExc_ValueError, "%s is not supported", params[i].base_vertex && !self->ctx->base_vertex_support ? "base_vertex" : "base_instance");
+            return NULL;
+        }
+    }
+
+    if (count) {
+        bind_pipeline(self, (Viewport *)self->viewport_data_buffer.buf, (char *)self->uniform_data_buffer.buf, self->dynamic_offset);
+        if (!multi_draw_functions || count == 1 || !multi_draw_pipeline(self, params, count)) {
+            for (int i = 0; i < count; ++i) {
+                draw_pipeline(self, &params[i], 1);
+            }
+        }
+    }
+
+    PyBuffer_Release(&view);
+    Py_DECREF(mem);
+    Py_RETURN_NONE;
+}
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|ii", keywords, &layer, &level)) {
-        return NULL;
-    }
+static PyObject * Pipeline_get_viewport(Pipeline * self, void * closure) {
+    return Py_BuildValue("(iiii)", self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
+}
 
-    if (layer < 0 || layer >= self->layer_count) {
-        PyErr_Format(PyExc_ValueError, "invalid layer");
-        return NULL;
+static int Pipeline_set_viewport(Pipeline * self, PyObject * viewport, void * closure) {
+    if (!check_context_idle(self->ctx)) {
+        return -1;
     }
 
-    if (level > self->level_count) {
-        PyErr_Format(PyExc_ValueError, "invalid level");
-        return NULL;
+    self->viewport = to_viewport(viewport, 0, 0, 0, 0);
+    if (PyErr_Occurred()) {
+        PyErr_Format(PyExc_TypeError, "the viewport must be a tuple of 4 ints");
+        return -1;
     }
+    return 0;
+}
 
-    PyObject * key = Py_BuildValue("(ii)", layer, level);
-    ImageFace * res = build_image_face(self, key);
-    Py_DECREF(key);
-    return res;
+static PyObject * Pipeline_get_dynamic_offset(Pipeline * self, void * closure) {
+    return PyLong_FromSsize_t(self->dynamic_offset);
 }
 
-static PyObject * Image_get_clear_value(Image * self, void * closure) {
-    if (self->fmt.clear_type == 'x') {
-        return Py_BuildValue("dI", (double)self->clear_value.clear_floats[0], self->clear_value.clear_uints[1]);
+static int Pipeline_set_dynamic_offset(Pipeline * self, PyObject * value, void * closure) {
+    if (!value || !PyLong_CheckExact(value)) {
+        PyErr_Format(PyExc_TypeError, "the dynamic_offset must be an int");
+        return -1;
     }
-    if (self->fmt.components == 1) {
-        if (self->fmt.clear_type == 'f') {
-            return PyFloat_FromDouble(self->clear_value.clear_floats[0]);
-        } else if (self->fmt.clear_type == 'i') {
-            return PyLong_FromLong(self->clear_value.clear_ints[0]);
-        } else if (self->fmt.clear_type == 'u') {
-            return PyLong_FromUnsignedLong(self->clear_value.clear_uints[0]);
-        }
+    const intptr dynamic_offset = to_intptr(value);
+    if (PyErr_Occurred()) {
+        return -1;
     }
-    PyObject * res = PyTuple_New(self->fmt.components);
-    for (int i = 0; i < self->fmt.components; ++i) {
-        if (self->fmt.clear_type == 'f') {
-            PyTuple_SetItem(res, i, PyFloat_FromDouble(self->clear_value.clear_floats[i]));
-        } else if (self->fmt.clear_type == 'i') {
-            PyTuple_SetItem(res, i, PyLong_FromLong(self->clear_value.clear_ints[i]));
-        } else if (self->fmt.clear_type == 'u') {
-            PyTuple_SetItem(res, i, PyLong_FromUnsignedLong(self->clear_value.clear_uints[i]));
-        }
+    const int alignment = self->ctx->limits.uniform_buffer_offset_alignment;
+    if (dynamic_offset < 0 || (alignment > 1 && dynamic_offset % alignment)) {
+        PyErr_Format(PyExc_ValueError, "the dynamic_offset must be a non-negative multiple of %d", alignment);
+        return -1;
     }
-    return res;
-}
-
-static int Image_set_clear_value(Image * self, PyObject * value, void * closure) {
-    if (self->fmt.components == 1) {
-        if (self->fmt.clear_type == 'f' && !PyFloat_CheckExact(value)) {
-            PyErr_Format(PyExc_TypeError, "the clear value must be a float");
+    DescriptorSetBuffers * buffers = &self->descriptor_set->uniform_buffers;
+    for (int i = 0; i < buffers->binding_count; ++i) {
+        BufferBinding * binding = &buffers->binding[i];
+        if (binding->dynamic && binding->offset + dynamic_offset + binding->size > binding->buffer->size) {
+            PyErr_Format(PyExc_ValueError, "the dynamic_offset is out of range for the uniform buffer at binding %d", i);
             return -1;
         }
-        if (self->fmt.clear_type == 'i' && !PyLong_CheckExact(value)) {
-            PyErr_Format(PyExc_TypeError, "the clear value must be an int");
-            return -1;
-        }
-        if (self->fmt.clear_type == 'f') {
-            self->clear_value.clear_floats[0] = to_float(value);
-        } else if (self->fmt.clear_type == 'i') {
-            self->clear_value.clear_ints[0] = to_int(value);
-        } else if (self->fmt.clear_type == 'u') {
-            self->clear_value.clear_uints[0] = to_uint(value);
-        }
-        return 0;
-    }
-    PyObject * values = PySequence_Tuple(value);
-    if (!values) {
-        PyErr_Clear();
-        PyErr_Format(PyExc_TypeError, "the clear value must be a tuple");
-        return -1;
     }
+    self->dynamic_offset = dynamic_offset;
+    return 0;
+}
 
-    int size = (int)PyTuple_Size(values);
+static PyObject * Pipeline_get_indirect_count(Pipeline * self, void * closure) {
+    return PyLong_FromLong(self->indirect_count);
+}
 
-    if (size != self->fmt.components) {
-        Py_DECREF(values);
-        PyErr_Format(PyExc_ValueError, "invalid clear value size");
+static int Pipeline_set_indirect_count(Pipeline * self, PyObject * value, void * closure) {
+    if (!value || !PyLong_CheckExact(value)) {
+        PyErr_Format(PyExc_TypeError, "the indirect_count must be an int");
         return -1;
     }
-
-    if (self->fmt.clear_type == 'f') {
-        for (int i = 0; i < self->fmt.components; ++i) {
-            self->clear_value.clear_floats[i] = to_float(PyTuple_GetItem(values, i));
-        }
-    } else if (self->fmt.clear_type == 'i') {
-        for (int i = 0; i < self->fmt.components; ++i) {
-            self->clear_value.clear_ints[i] = to_int(PyTuple_GetItem(values, i));
-        }
-    } else if (self->fmt.clear_type == 'u') {
-        for (int i = 0; i < self->fmt.components; ++i) {
-            self->clear_value.clear_uints[i] = to_uint(PyTuple_GetItem(values, i));
-        }
-    } else if (self->fmt.clear_type == 'x') {
-        self->clear_value.clear_floats[0] = to_float(PyTuple_GetItem(values, 0));
-        self->clear_value.clear_ints[1] = to_int(PyTuple_GetItem(values, 1));
-    }
+    const int indirect_count = to_int(value);
     if (PyErr_Occurred()) {
-        Py_DECREF(values);
         return -1;
     }
-    Py_DECREF(values);
+    if (indirect_count < 0 || (self->indirect_buffer && (intptr)indirect_count * (self->index_type ? 20 : 16) > self->indirect_size)) {
+        PyErr_Format(PyExc_ValueError, "the indirect_buffer is too small for %d draws", indirect_count);
+        return -1;
+    }
+    self->indirect_count = indirect_count;
     return 0;
 }
 
-static PyObject * Pipeline_meth_render(Pipeline * self, PyObject * args) {
-    Viewport * viewport = (Viewport *)self->viewport_data_buffer.buf;
-    bind_viewport(self->ctx, viewport);
-    bind_global_settings(self->ctx, self->global_settings);
-    bind_draw_framebuffer(self->ctx, self->framebuffer->obj);
-    bind_program(self->ctx, self->program->obj);
-    bind_vertex_array(self->ctx, self->vertex_array->obj);
-    bind_descriptor_set(self->ctx, self->descriptor_set);
-    if (self->uniforms) {
-        bind_uniforms(self);
+static PyObject * Pipeline_get_base_vertex(Pipeline * self, void * closure) {
+    return PyLong_FromLong(self->params.base_vertex);
+}
+
+static int Pipeline_set_base_vertex(Pipeline * self, PyObject * value, void * closure) {
+    if (!value || !PyLong_CheckExact(value)) {
+        PyErr_Format(PyExc_TypeError, "the base_vertex must be an int");
+        return -1;
     }
-    RenderParameters * params = (RenderParameters *)self->render_data_buffer.buf;
-    if (self->index_type) {
-        intptr offset = (intptr)params->first_vertex * (intptr)self->index_size;
-        glDrawElementsInstanced(self->topology, params->vertex_count, self->index_type, offset, params->instance_count);
-    } else {
-        glDrawArraysInstanced(self->topology, params->first_vertex, params->vertex_count, params->instance_count);
+    const int base_vertex = to_int(value);
+    if (PyErr_Occurred()) {
+        return -1;
     }
-    Py_RETURN_NONE;
+    if (base_vertex && !self->ctx->base_vertex_support) {
+        PyErr_Format(PyExc_ValueError, "base_vertex is not supported");
+        return -1;
+    }
+    self->params.base_vertex = base_vertex;
+    return 0;
 }
 
-static PyObject * Pipeline_get_viewport(Pipeline * self, void * closure) {
-    return Py_BuildValue("(iiii)", self->viewport.x, self->viewport.y, self->viewport.width, self->viewport.height);
+static PyObject * Pipeline_get_base_instance(Pipeline * self, void * closure) {
+    return PyLong_FromLong(self->params.base_instance);
 }
 
-static int Pipeline_set_viewport(Pipeline * self, PyObject * viewport, void * closure) {
-    self->viewport = to_viewport(viewport, 0, 0, 0, 0);
+static int Pipeline_set_base_instance(Pipeline * self, PyObject * value, void * closure) {
+    if (!value || !PyLong_CheckExact(value)) {
+        PyErr_Format(PyExc_TypeError, "the base_instance must be an int");
+        return -1;
+    }
+    const int base_instance = to_int(value);
     if (PyErr_Occurred()) {
-        PyErr_Format(PyExc_TypeError, "the viewport must be a tuple of 4 ints");
         return -1;
     }
+    if (base_instance && !self->ctx->base_instance_support) {
+        PyErr_Format(PyExc_ValueError, "base_instance is not supported");
+        return -1;
+    }
+    self->params.base_instance = base_instance;
     return 0;
 }
 
@@ -3218,12 +6341,13 @@ static PyObject * inspect_descriptor_set(DescriptorSet * set) {
     for (int i = 0; i < set->uniform_buffers.binding_count; ++i) {
         if (set->uniform_buffers.binding[i].buffer) {
             PyObject * obj = Py_BuildValue(
-                "{sssisisisi}",
+                "{sssisisisisO}",
                 "type", "uniform_buffer",
                 "binding", i,
                 "buffer", set->uniform_buffers.binding[i].buffer->buffer,
                 "offset", set->uniform_buffers.binding[i].offset,
-                "size", set->uniform_buffers.binding[i].size
+                "size", set->uniform_buffers.binding[i].size,
+                "dynamic", set->uniform_buffers.binding[i].dynamic ? Py_True : Py_False
             );
             PyList_Append(res, obj);
             Py_DECREF(obj);
@@ -3273,12 +6397,30 @@ static PyObject * meth_inspect(PyObject * self, PyObject * arg) {
 }
 
 static PyObject * ImageFace_meth_clear(ImageFace * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    if (self->image->fmt.compressed) {
+        PyErr_Format(PyExc_TypeError, "cannot clear compressed images");
+        return NULL;
+    }
+    if (self->image->fmt.clear_type == 'e') {
+        if (!clear_shared_exponent_face(self)) {
+            return NULL;
+        }
+        Py_RETURN_NONE;
+    }
     bind_draw_framebuffer(self->ctx, self->framebuffer->obj);
     clear_bound_image(self->image);
     Py_RETURN_NONE;
 }
 
 static PyObject * ImageFace_meth_read(ImageFace * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
     static char * keywords[] = {"size", "offset", "into", NULL};
 
     PyObject * size_arg = Py_None;
@@ -3297,7 +6439,106 @@ static PyObject * ImageFace_meth_read(ImageFace * self, PyObject * args, PyObjec
     return read_image_face(self, size, offset, into);
 }
 
+static Readback * ImageFace_meth_read_async(ImageFace * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"size", "offset", NULL};
+
+    PyObject * size_arg = Py_None;
+    PyObject * offset_arg = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OO", keywords, &size_arg, &offset_arg)) {
+        return NULL;
+    }
+
+    IntPair size, offset;
+    if (!parse_size_and_offset(self, size_arg, offset_arg, &size, &offset)) {
+        return NULL;
+    }
+
+    PyObject * faces = PyTuple_Pack(1, self);
+    Readback * res = read_image_faces_async(self->image, faces, size, offset);
+    Py_DECREF(faces);
+    return res;
+}
+
+static PyObject * Readback_meth_ready(Readback * self, PyObject * args) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    if (!self->fence) {
+        Py_RETURN_TRUE;
+    }
+    int status = glClientWaitSync(self->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    return PyBool_FromLong(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED);
+}
+
+static PyObject * Readback_meth_result(Readback * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
+    static char * keywords[] = {"into", NULL};
+
+    PyObject * into = Py_None;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", keywords, &into)) {
+        return NULL;
+    }
+
+    if (!self->fence) {
+        PyErr_Format(PyExc_ValueError, "the result was already collected");
+        return NULL;
+    }
+
+    PyObject * res = NULL;
+    Py_buffer view;
+    void * ptr = NULL;
+
+    if (into == Py_None) {
+        res = PyBytes_FromStringAndSize(NULL, self->size);
+        if (!res) {
+            return NULL;
+        }
+        ptr = PyBytes_AsString(res);
+    } else {
+        if (PyObject_GetBuffer(into, &view, PyBUF_WRITABLE)) {
+            return NULL;
+        }
+        if (self->size > view.len) {
+            PyBuffer_Release(&view);
+            PyErr_Format(PyExc_ValueError, "invalid write size");
+            return NULL;
+        }
+        ptr = view.buf;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    glClientWaitSync(self->fence, GL_SYNC_FLUSH_COMMANDS_BIT, -1);
+    glDeleteSync(self->fence);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, self->buffer.buffer);
+    get_buffer_sub_data(GL_PIXEL_PACK_BUFFER, 0, self->size, (char *)ptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    Py_END_ALLOW_THREADS
+    self->fence = NULL;
+    release_readback_buffer(self->ctx, self->buffer);
+
+    if (into == Py_None) {
+        return res;
+    }
+
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
+
 static PyObject * ImageFace_meth_blit(ImageFace * self, PyObject * args, PyObject * kwargs) {
+    if (!check_context_idle(self->ctx)) {
+        return NULL;
+    }
+
     static char * keywords[] = {"target", "target_viewport", "source_viewport", "filter", NULL};
 
     PyObject * target = Py_None;
@@ -3433,6 +6674,15 @@ static void Context_dealloc(Context * self) {
     Py_DECREF(self->before_frame_callback);
     Py_DECREF(self->after_frame_callback);
     Py_DECREF(self->info_dict);
+    Py_XDECREF(self->compressed_formats);
+    Py_XDECREF(self->extension_formats);
+    Py_DECREF(self->program_binary_cache);
+    Py_DECREF(self->profile_results);
+    delete_queries(self, 1);
+    release_pending_readbacks(self);
+    PyMem_Free(self->pending_readbacks);
+    PyMem_Free(self->profile_events);
+    PyMem_Free(self->profile_queries);
     PyObject_Del(self);
 }
 
@@ -3440,7 +6690,13 @@ static void Buffer_dealloc(Buffer * self) {
     PyObject_Del(self);
 }
 
+static void BufferMapping_dealloc(BufferMapping * self) {
+    Py_DECREF(self->buffer);
+    PyObject_Del(self);
+}
+
 static void Image_dealloc(Image * self) {
+    Py_XDECREF((PyObject *)self->resolve_target);
     Py_DECREF(self->size);
     Py_DECREF(self->format);
     Py_DECREF(self->faces);
@@ -3459,6 +6715,37 @@ static void Pipeline_dealloc(Pipeline * self) {
     Py_XDECREF(self->uniform_data);
     Py_DECREF(self->viewport_data);
     Py_DECREF(self->render_data);
+    Py_XDECREF((PyObject *)self->indirect_buffer);
+    Py_XDECREF(self->label);
+    PyObject_Del(self);
+}
+
+static void Readback_dealloc(Readback * self) {
+    if (self->fence && self->ctx->flushing) {
+        defer_readback(self->ctx, self->fence, self->buffer);
+    } else if (self->fence) {
+        glDeleteSync(self->fence);
+        release_readback_buffer(self->ctx, self->buffer);
+    }
+    Py_DECREF(self->ctx);
+    PyObject_Del(self);
+}
+
+static void DrawQueue_dealloc(DrawQueue * self) {
+    clear_draw_queue(self);
+    PyMem_Free(self->commands);
+    PyMem_Free(self->uniform_data);
+    Py_DECREF(self->ctx);
+    PyObject_Del(self);
+}
+
+static void BufferArena_dealloc(BufferArena * self) {
+    for (int i = 0; i < self->count; ++i) {
+        Py_DECREF(self->blocks[i].view);
+    }
+    PyMem_Free(self->blocks);
+    Py_DECREF(self->buffer);
+    Py_DECREF(self->ctx);
     PyObject_Del(self);
 }
 
@@ -3474,10 +6761,12 @@ static void BufferView_dealloc(BufferView * self) {
 }
 
 static void DescriptorSet_dealloc(DescriptorSet * self) {
+    Py_DECREF(self->key);
     PyObject_Del(self);
 }
 
 static void GlobalSettings_dealloc(GlobalSettings * self) {
+    Py_DECREF(self->key);
     PyObject_Del(self);
 }
 
@@ -3485,6 +6774,8 @@ static void GLObject_dealloc(GLObject * self) {
     if (self->extra) {
         Py_DECREF(self->extra);
     }
+    Py_DECREF(self->key);
+    PyMem_Free(self->shadow);
     PyObject_Del(self);
 }
 
@@ -3495,12 +6786,17 @@ static PyMethodDef Context_methods[] = {
     {"new_frame", (PyCFunction)Context_meth_new_frame, METH_VARARGS | METH_KEYWORDS, NULL},
     {"end_frame", (PyCFunction)Context_meth_end_frame, METH_VARARGS | METH_KEYWORDS, NULL},
     {"release", (PyCFunction)Context_meth_release, METH_O, NULL},
+    {"render", (PyCFunction)Context_meth_render, METH_O, NULL},
+    {"draw_queue", (PyCFunction)Context_meth_draw_queue, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"buffer_arena", (PyCFunction)Context_meth_buffer_arena, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"profile", (PyCFunction)Context_meth_profile, METH_NOARGS, NULL},
     {"gc", (PyCFunction)Context_meth_gc, METH_NOARGS, NULL},
     {0},
 };
 
 static PyGetSetDef Context_getset[] = {
     {"screen", (getter)Context_get_screen, (setter)Context_set_screen, NULL, NULL},
+    {"program_binary_cache", (getter)Context_get_program_binary_cache, (setter)Context_set_program_binary_cache, NULL, NULL},
     {0},
 };
 
@@ -3510,6 +6806,8 @@ static PyMemberDef Context_members[] = {
     {"before_frame", T_OBJECT, offsetof(Context, before_frame_callback), 0, NULL},
     {"after_frame", T_OBJECT, offsetof(Context, after_frame_callback), 0, NULL},
     {"frame_time", T_INT, offsetof(Context, frame_time), READONLY, NULL},
+    {"frame_time_latency", T_INT, offsetof(Context, frame_time_latency), READONLY, NULL},
+    {"skipped_uniform_calls", T_INT, offsetof(Context, skipped_uniform_calls), READONLY, NULL},
     {0},
 };
 
@@ -3517,11 +6815,34 @@ static PyMethodDef Buffer_methods[] = {
     {"write", (PyCFunction)Buffer_meth_write, METH_VARARGS | METH_KEYWORDS, NULL},
     {"read", (PyCFunction)Buffer_meth_read, METH_VARARGS | METH_KEYWORDS, NULL},
     {"view", (PyCFunction)Buffer_meth_view, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"map", (PyCFunction)Buffer_meth_map, METH_NOARGS, NULL},
+    {"stream", (PyCFunction)Buffer_meth_stream, METH_VARARGS | METH_KEYWORDS, NULL},
     {0},
 };
 
 static PyMemberDef Buffer_members[] = {
-    {"size", T_INT, offsetof(Buffer, size), READONLY, NULL},
+    {"size", T_PYSSIZET, offsetof(Buffer, size), READONLY, NULL},
+    {"persistent", T_INT, offsetof(Buffer, persistent), READONLY, NULL},
+    {0},
+};
+
+static PyMethodDef BufferArena_methods[] = {
+    {"allocate", (PyCFunction)BufferArena_meth_allocate, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"free", (PyCFunction)BufferArena_meth_free, METH_O, NULL},
+    {"defragment", (PyCFunction)BufferArena_meth_defragment, METH_NOARGS, NULL},
+    {"stats", (PyCFunction)BufferArena_meth_stats, METH_NOARGS, NULL},
+    {0},
+};
+
+static PyMemberDef BufferArena_members[] = {
+    {"buffer", T_OBJECT, offsetof(BufferArena, buffer), READONLY, NULL},
+    {0},
+};
+
+static PyMemberDef BufferView_members[] = {
+    {"buffer", T_OBJECT, offsetof(BufferView, buffer), READONLY, NULL},
+    {"offset", T_PYSSIZET, offsetof(BufferView, offset), READONLY, NULL},
+    {"size", T_PYSSIZET, offsetof(BufferView, size), READONLY, NULL},
     {0},
 };
 
@@ -3530,6 +6851,8 @@ static PyMethodDef Image_methods[] = {
     {"write", (PyCFunction)Image_meth_write, METH_VARARGS | METH_KEYWORDS, NULL},
     {"read", (PyCFunction)Image_meth_read, METH_VARARGS | METH_KEYWORDS, NULL},
     {"mipmaps", (PyCFunction)Image_meth_mipmaps, METH_NOARGS, NULL},
+    {"resolve", (PyCFunction)Image_meth_resolve, METH_NOARGS, NULL},
+    {"read_async", (PyCFunction)Image_meth_read_async, METH_VARARGS | METH_KEYWORDS, NULL},
     {"blit", (PyCFunction)Image_meth_blit, METH_VARARGS | METH_KEYWORDS, NULL},
     {"face", (PyCFunction)Image_meth_face, METH_VARARGS | METH_KEYWORDS, NULL},
     {0},
@@ -3550,11 +6873,16 @@ static PyMemberDef Image_members[] = {
 
 static PyMethodDef Pipeline_methods[] = {
     {"render", (PyCFunction)Pipeline_meth_render, METH_NOARGS, NULL},
+    {"render_multi", (PyCFunction)Pipeline_meth_render_multi, METH_O, NULL},
     {0},
 };
 
 static PyGetSetDef Pipeline_getset[] = {
     {"viewport", (getter)Pipeline_get_viewport, (setter)Pipeline_set_viewport, NULL, NULL},
+    {"dynamic_offset", (getter)Pipeline_get_dynamic_offset, (setter)Pipeline_set_dynamic_offset, NULL, NULL},
+    {"indirect_count", (getter)Pipeline_get_indirect_count, (setter)Pipeline_set_indirect_count, NULL, NULL},
+    {"base_vertex", (getter)Pipeline_get_base_vertex, (setter)Pipeline_set_base_vertex, NULL, NULL},
+    {"base_instance", (getter)Pipeline_get_base_instance, (setter)Pipeline_set_base_instance, NULL, NULL},
     {0},
 };
 
@@ -3563,12 +6891,37 @@ static PyMemberDef Pipeline_members[] = {
     {"instance_count", T_INT, offsetof(Pipeline, params.instance_count), 0, NULL},
     {"first_vertex", T_INT, offsetof(Pipeline, params.first_vertex), 0, NULL},
     {"uniforms", T_OBJECT, offsetof(Pipeline, uniforms), READONLY, NULL},
+    {"label", T_OBJECT, offsetof(Pipeline, label), 0, NULL},
+    {0},
+};
+
+static PyMethodDef DrawQueue_methods[] = {
+    {"add", (PyCFunction)DrawQueue_meth_add, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"flush", (PyCFunction)DrawQueue_meth_flush, METH_NOARGS, NULL},
+    {"clear", (PyCFunction)DrawQueue_meth_clear, METH_NOARGS, NULL},
+    {0},
+};
+
+static PyMemberDef DrawQueue_members[] = {
+    {"saved_binds", T_INT, offsetof(DrawQueue, saved_binds), READONLY, NULL},
+    {0},
+};
+
+static PyMethodDef Readback_methods[] = {
+    {"ready", (PyCFunction)Readback_meth_ready, METH_NOARGS, NULL},
+    {"result", (PyCFunction)Readback_meth_result, METH_VARARGS | METH_KEYWORDS, NULL},
+    {0},
+};
+
+static PyMemberDef Readback_members[] = {
+    {"size", T_PYSSIZET, offsetof(Readback, size), READONLY, NULL},
     {0},
 };
 
 static PyMethodDef ImageFace_methods[] = {
     {"clear", (PyCFunction)ImageFace_meth_clear, METH_NOARGS, NULL},
     {"read", (PyCFunction)ImageFace_meth_read, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"read_async", (PyCFunction)ImageFace_meth_read_async, METH_VARARGS | METH_KEYWORDS, NULL},
     {"blit", (PyCFunction)ImageFace_meth_blit, METH_VARARGS | METH_KEYWORDS, NULL},
     {0},
 };
@@ -3614,6 +6967,21 @@ static PyType_Slot Pipeline_slots[] = {
     {0},
 };
 
+static PyType_Slot DrawQueue_slots[] = {
+    {Py_tp_methods, DrawQueue_methods},
+    {Py_tp_members, DrawQueue_members},
+    {Py_sq_length, (void *)DrawQueue_len},
+    {Py_tp_dealloc, (void *)DrawQueue_dealloc},
+    {0},
+};
+
+static PyType_Slot Readback_slots[] = {
+    {Py_tp_methods, Readback_methods},
+    {Py_tp_members, Readback_members},
+    {Py_tp_dealloc, (void *)Readback_dealloc},
+    {0},
+};
+
 static PyType_Slot ImageFace_slots[] = {
     {Py_tp_methods, ImageFace_methods},
     {Py_tp_members, ImageFace_members},
@@ -3621,11 +6989,27 @@ static PyType_Slot ImageFace_slots[] = {
     {0},
 };
 
+static PyType_Slot BufferMapping_slots[] = {
+    {Py_bf_getbuffer, (void *)BufferMapping_getbuffer},
+    {Py_bf_releasebuffer, (void *)BufferMapping_releasebuffer},
+    {Py_tp_dealloc, (void *)BufferMapping_dealloc},
+    {0},
+};
+
 static PyType_Slot BufferView_slots[] = {
+    {Py_tp_members, BufferView_members},
     {Py_tp_dealloc, (void *)BufferView_dealloc},
     {0},
 };
 
+static PyType_Slot BufferArena_slots[] = {
+    {Py_tp_methods, BufferArena_methods},
+    {Py_tp_members, BufferArena_members},
+    {Py_sq_length, (void *)BufferArena_len},
+    {Py_tp_dealloc, (void *)BufferArena_dealloc},
+    {0},
+};
+
 static PyType_Slot DescriptorSet_slots[] = {
     {Py_tp_dealloc, (void *)DescriptorSet_dealloc},
     {0},
@@ -3645,8 +7029,12 @@ static PyType_Spec Context_spec = {"zengl.Context", sizeof(Context), 0, Py_TPFLA
 static PyType_Spec Buffer_spec = {"zengl.Buffer", sizeof(Buffer), 0, Py_TPFLAGS_DEFAULT, Buffer_slots};
 static PyType_Spec Image_spec = {"zengl.Image", sizeof(Image), 0, Py_TPFLAGS_DEFAULT, Image_slots};
 static PyType_Spec Pipeline_spec = {"zengl.Pipeline", sizeof(Pipeline), 0, Py_TPFLAGS_DEFAULT, Pipeline_slots};
+static PyType_Spec DrawQueue_spec = {"zengl.DrawQueue", sizeof(DrawQueue), 0, Py_TPFLAGS_DEFAULT, DrawQueue_slots};
+static PyType_Spec Readback_spec = {"zengl.Readback", sizeof(Readback), 0, Py_TPFLAGS_DEFAULT, Readback_slots};
 static PyType_Spec ImageFace_spec = {"zengl.ImageFace", sizeof(ImageFace), 0, Py_TPFLAGS_DEFAULT, ImageFace_slots};
+static PyType_Spec BufferMapping_spec = {"zengl.BufferMapping", sizeof(BufferMapping), 0, Py_TPFLAGS_DEFAULT, BufferMapping_slots};
 static PyType_Spec BufferView_spec = {"zengl.BufferView", sizeof(BufferView), 0, Py_TPFLAGS_DEFAULT, BufferView_slots};
+static PyType_Spec BufferArena_spec = {"zengl.BufferArena", sizeof(BufferArena), 0, Py_TPFLAGS_DEFAULT, BufferArena_slots};
 static PyType_Spec DescriptorSet_spec = {"zengl.DescriptorSet", sizeof(DescriptorSet), 0, Py_TPFLAGS_DEFAULT, DescriptorSet_slots};
 static PyType_Spec GlobalSettings_spec = {"zengl.GlobalSettings", sizeof(GlobalSettings), 0, Py_TPFLAGS_DEFAULT, GlobalSettings_slots};
 static PyType_Spec GLObject_spec = {"zengl.GLObject", sizeof(GLObject), 0, Py_TPFLAGS_DEFAULT, GLObject_slots};
@@ -3669,8 +7057,12 @@ static int module_exec(PyObject * self) {
     state->Buffer_type = (PyTypeObject *)PyType_FromSpec(&Buffer_spec);
     state->Image_type = (PyTypeObject *)PyType_FromSpec(&Image_spec);
     state->Pipeline_type = (PyTypeObject *)PyType_FromSpec(&Pipeline_spec);
+    state->DrawQueue_type = (PyTypeObject *)PyType_FromSpec(&DrawQueue_spec);
+    state->Readback_type = (PyTypeObject *)PyType_FromSpec(&Readback_spec);
     state->ImageFace_type = (PyTypeObject *)PyType_FromSpec(&ImageFace_spec);
     state->BufferView_type = (PyTypeObject *)PyType_FromSpec(&BufferView_spec);
+    state->BufferMapping_type = (PyTypeObject *)PyType_FromSpec(&BufferMapping_spec);
+    state->BufferArena_type = (PyTypeObject *)PyType_FromSpec(&BufferArena_spec);
     state->DescriptorSet_type = (PyTypeObject *)PyType_FromSpec(&DescriptorSet_spec);
     state->GlobalSettings_type = (PyTypeObject *)PyType_FromSpec(&GlobalSettings_spec);
     state->GLObject_type = (PyTypeObject *)PyType_FromSpec(&GLObject_spec);
@@ -3681,6 +7073,9 @@ static int module_exec(PyObject * self) {
     PyModule_AddObject(self, "ImageFace", new_ref(state->ImageFace_type));
     PyModule_AddObject(self, "BufferView", new_ref(state->BufferView_type));
     PyModule_AddObject(self, "Pipeline", new_ref(state->Pipeline_type));
+    PyModule_AddObject(self, "DrawQueue", new_ref(state->DrawQueue_type));
+    PyModule_AddObject(self, "Readback", new_ref(state->Readback_type));
+    PyModule_AddObject(self, "BufferArena", new_ref(state->BufferArena_type));
 
     PyModule_AddObject(self, "loader", PyObject_GetAttrString(state->helper, "loader"));
     PyModule_AddObject(self, "calcsize", PyObject_GetAttrString(state->helper, "calcsize"));
@@ -3701,6 +7096,9 @@ static PyMethodDef module_methods[] = {
     {"context", (PyCFunction)meth_context, METH_NOARGS, NULL},
     {"inspect", (PyCFunction)meth_inspect, METH_O, NULL},
     {"camera", (PyCFunction)meth_camera, METH_VARARGS | METH_KEYWORDS, NULL},
+#ifndef EXTERN_GL
+    {"null_loader", (PyCFunction)meth_null_loader, METH_VARARGS | METH_KEYWORDS, NULL},
+#endif
     {0},
 };
 
@@ -3717,7 +7115,11 @@ static void module_free(PyObject * self) {
         Py_DECREF(state->Buffer_type);
         Py_DECREF(state->Image_type);
         Py_DECREF(state->Pipeline_type);
+        Py_DECREF(state->DrawQueue_type);
+        Py_DECREF(state->Readback_type);
         Py_DECREF(state->ImageFace_type);
+        Py_DECREF(state->BufferArena_type);
+        Py_DECREF(state->BufferMapping_type);
         Py_DECREF(state->DescriptorSet_type);
         Py_DECREF(state->GlobalSettings_type);
         Py_DECREF(state->GLObject_type);